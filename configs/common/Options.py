@@ -269,6 +269,21 @@ def addCommonOptions(parser):
     parser.add_option("-p", "--prog-interval", type="str",
         help="CPU Progress Interval")
 
+    # Sampling - fast-forward with an atomic CPU and fork a detailed
+    # simulation of --cpu-type at every sample point
+    parser.add_option("--sample-period", action="store", type="int",
+        default=None,
+        help="fork a detailed sample every <N> ticks")
+    parser.add_option("--sample-warmup", action="store", type="int",
+        default=0,
+        help="detailed warm-up of every sample in ticks")
+    parser.add_option("--sample-length", action="store", type="int",
+        default=None,
+        help="detailed measurement of every sample in ticks")
+    parser.add_option("--sample-jobs", action="store", type="int",
+        default=0,
+        help="samples simulated concurrently (default: host cores - 1)")
+
     # Fastforwarding and simpoint related materials
     parser.add_option("-W", "--warmup-insts", action="store", type="int",
         default=None,
@@ -278,6 +293,10 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_option("--fast-forward-superblocks", action="store_true",
+        default=False,
+        help="""Fast forward from a cache of pre-decoded instruction
+                blocks, skipping instruction fetches""")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
@@ -78,7 +78,7 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.sample_period:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -441,6 +441,15 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.sample_period:
+        if options.fast_forward or options.standard_switch or \
+                options.repeat_switch or options.take_checkpoints or \
+                options.checkpoint_restore != None:
+            fatal("Can't specify --sample-period with --fast-forward, "
+                  "--standard-switch, --repeat-switch or checkpoints")
+        if not options.sample_length:
+            fatal("--sample-period requires --sample-length")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -459,6 +468,8 @@ def run(options, root, testsys, cpu_class):
         for i in xrange(np):
             if options.fast_forward:
                 testsys.cpu[i].max_insts_any_thread = int(options.fast_forward)
+                if options.fast_forward_superblocks:
+                    testsys.cpu[i].superblock_cache = True
             switch_cpus[i].system = testsys
             switch_cpus[i].workload = testsys.cpu[i].workload
             switch_cpus[i].clk_domain = testsys.cpu[i].clk_domain
@@ -586,6 +597,10 @@ def run(options, root, testsys, cpu_class):
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
+    # samples are forked off the simulator, which can't have listeners
+    if options.sample_period:
+        m5.disableAllListeners()
+
     m5.instantiate(checkpoint_dir)
 
     # Initialization is complete.  If we're not in control of simulation
@@ -630,7 +645,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.sample_period:
         if options.standard_switch:
             print "Switch at instruction count:%s" % \
                     str(testsys.cpu[0].max_insts_any_thread)
@@ -687,6 +702,15 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint != None:
         restoreSimpointCheckpoint()
 
+    # Fast-forward the workload and fork detailed samples
+    elif options.sample_period:
+        exit_event = m5.sampling.run(testsys, switch_cpu_list,
+                                     options.sample_period,
+                                     options.sample_warmup,
+                                     options.sample_length,
+                                     max_tick=maxtick,
+                                     jobs=options.sample_jobs)
+
     else:
         if options.fast_forward:
             m5.stats.reset()
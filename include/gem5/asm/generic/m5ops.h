@@ -72,7 +72,7 @@
 #define M5OP_ADD_SYMBOL         0x53
 #define M5OP_PANIC              0x54
 
-#define M5OP_RESERVED2          0x56 // Reserved for user
+#define M5OP_DUMP_TRACE         0x56
 #define M5OP_RESERVED3          0x57 // Reserved for user
 #define M5OP_RESERVED4          0x58 // Reserved for user
 #define M5OP_RESERVED5          0x59 // Reserved for user
@@ -126,6 +126,7 @@
     M5OP(m5_switch_cpu, M5OP_SWITCH_CPU, 0);                    \
     M5OP(m5_add_symbol, M5OP_ADD_SYMBOL, 0);                    \
     M5OP(m5_panic, M5OP_PANIC, 0);                              \
+    M5OP(m5_dump_trace, M5OP_DUMP_TRACE, 0);                    \
     M5OP(m5_work_begin, M5OP_WORK_BEGIN, 0);                    \
     M5OP(m5_work_end, M5OP_WORK_END, 0);                        \
     M5OP(m5_dist_togglesync, M5OP_DIST_TOGGLE_SYNC, 0);
@@ -40,40 +40,119 @@
 #ifndef __BASE_BARRIER_HH__
 #define __BASE_BARRIER_HH__
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
 
+/**
+ * A reusable barrier for a fixed number of threads.
+ *
+ * Threads arriving at the barrier first spin, with exponential
+ * backoff and then yielding the host CPU, for up to a configurable
+ * host time before blocking on a condition variable. Spinning keeps
+ * the threads out of the kernel when the barrier is entered at a
+ * high rate and all threads arrive within a short time of each
+ * other, e.g., when synchronizing event queues every few nanoseconds
+ * of simulated time. A spin budget of zero blocks immediately.
+ */
 class Barrier
 {
+  public:
+    typedef std::chrono::nanoseconds Duration;
+
   private:
-    /// Mutex to protect access to numLeft and generation
+    /// Mutex protecting the condition variable
     std::mutex bMutex;
     /// Condition variable for waiting on barrier
     std::condition_variable bCond;
     /// Number of threads we should be waiting for before completing the barrier
-    unsigned numWaiting;
+    const unsigned numWaiting;
     /// Generation of this barrier
-    unsigned generation;
+    std::atomic<unsigned> generation;
     /// Number of threads remaining for the current generation
-    unsigned numLeft;
+    std::atomic<unsigned> numLeft;
+    /// Host time to spin before blocking
+    Duration _spinBudget;
+
+    /// Longest backoff, in pause instructions, between two polls
+    static const unsigned maxBackoff = 64;
+
+    /// Hint to the processor that we are in a spin loop
+    static void
+    relax()
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    /// Spin until the generation changes or the budget is spent
+    bool
+    spin(unsigned gen) const
+    {
+        typedef std::chrono::steady_clock Clock;
+        const Clock::time_point deadline = Clock::now() + _spinBudget;
+        unsigned backoff = 1;
+
+        do {
+            for (unsigned i = 0; i < backoff; ++i) {
+                if (generation.load(std::memory_order_acquire) != gen)
+                    return true;
+                relax();
+            }
+            // Once the backoff saturates, give other threads a chance
+            // in case the host is oversubscribed
+            if (backoff < maxBackoff)
+                backoff *= 2;
+            else
+                std::this_thread::yield();
+        } while (Clock::now() < deadline);
+
+        return false;
+    }
 
   public:
-    Barrier(unsigned _numWaiting)
-        : numWaiting(_numWaiting), generation(0), numLeft(_numWaiting)
+    Barrier(unsigned _numWaiting, Duration spin_budget = Duration::zero())
+        : numWaiting(_numWaiting), generation(0), numLeft(_numWaiting),
+          _spinBudget(spin_budget)
     {}
 
+    /// Host time a thread spins before blocking
+    Duration spinBudget() const { return _spinBudget; }
+    void spinBudget(Duration budget) { _spinBudget = budget; }
+
+    /**
+     * Wait for all threads to arrive at the barrier.
+     *
+     * @return true for exactly one of the threads (the last one to
+     * arrive), false for all others.
+     */
     bool
     wait()
     {
-        std::unique_lock<std::mutex> lock(bMutex);
-        unsigned int gen = generation;
+        const unsigned gen = generation.load(std::memory_order_acquire);
 
-        if (--numLeft == 0) {
-            generation++;
-            numLeft = numWaiting;
+        if (numLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Re-arm the barrier before releasing the waiting threads
+            // since they may enter the next generation right away.
+            numLeft.store(numWaiting, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(bMutex);
+                generation.fetch_add(1, std::memory_order_release);
+            }
             bCond.notify_all();
             return true;
         }
-        while (gen == generation)
+
+        if (_spinBudget > Duration::zero() && spin(gen))
+            return false;
+
+        std::unique_lock<std::mutex> lock(bMutex);
+        while (generation.load(std::memory_order_acquire) == gen)
             bCond.wait(lock);
         return false;
     }
@@ -178,9 +178,15 @@ findMsbSet(uint64_t val) {
  */
 inline int
 findLsbSet(uint64_t val) {
-    int lsb = 0;
     if (!val)
         return sizeof(val) * 8;
+#ifndef __has_builtin
+    #define __has_builtin(foo) 0
+#endif
+#if defined(__GNUC__) || (defined(__clang__) && __has_builtin(__builtin_ctzll))
+    return __builtin_ctzll(val);
+#else
+    int lsb = 0;
     if (!bits(val, 31,0)) { lsb += 32; val >>= 32; }
     if (!bits(val, 15,0)) { lsb += 16; val >>= 16; }
     if (!bits(val, 7,0))  { lsb += 8;  val >>= 8;  }
@@ -188,6 +194,7 @@ findLsbSet(uint64_t val) {
     if (!bits(val, 1,0))  { lsb += 2;  val >>= 2;  }
     if (!bits(val, 0,0))  { lsb += 1; }
     return lsb;
+#endif
 }
 
 /**
@@ -46,6 +46,7 @@ ObjectMatch::ObjectMatch(const string &expr)
 void
 ObjectMatch::setExpression(const string &expr)
 {
+    tokens.clear();
     tokens.resize(1);
     tokenize(tokens[0], expr, '.');
 }
@@ -53,9 +54,8 @@ ObjectMatch::setExpression(const string &expr)
 void
 ObjectMatch::setExpression(const vector<string> &expr)
 {
-    if (expr.empty()) {
-        tokens.resize(0);
-    } else {
+    tokens.clear();
+    if (!expr.empty()) {
         tokens.resize(expr.size());
         for (vector<string>::size_type i = 0; i < expr.size(); ++i)
             tokenize(tokens[i], expr[i], '.');
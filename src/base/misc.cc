@@ -111,4 +111,9 @@ ExitLogger::printEpilogue(const char *func, const char *file, int line,
     Logger::printEpilogue(func, file, line, format);
 
     ccprintf(stream, "Memory Usage: %ld KBytes\n", memUsage());
+
+    // keep the debug messages and instructions that led here, e.g.,
+    // those buffered by flight recorders
+    dumpFlightRecorders();
+    Trace::getDebugLogger()->flush();
 }
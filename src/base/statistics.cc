@@ -30,6 +30,7 @@
 
 #include "base/statistics.hh"
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <list>
@@ -59,6 +60,32 @@ statsList()
     return the_list;
 }
 
+vector<Info *> &
+dumpOrder()
+{
+    static vector<Info *> the_order;
+    return the_order;
+}
+
+void
+prepareAll()
+{
+    for (Info *info : dumpOrder())
+        info->prepare();
+}
+
+void
+dumpTo(Output &output)
+{
+    output.begin();
+    for (Info *info : dumpOrder()) {
+        if (output.sparse && info->untouched())
+            continue;
+        info->visit(output);
+    }
+    output.end();
+}
+
 MapType &
 statsMap()
 {
@@ -376,6 +403,58 @@ HistStor::add(HistStor *hs)
         cvec[i] += hs->cvec[i];
 }
 
+std::mutex ShardTable::tablesMutex;
+__thread ShardTable *ShardTable::_local = nullptr;
+
+vector<ShardTable *> &
+ShardTable::tables()
+{
+    // Never destroyed, stats are destroyed after the static objects
+    // of this file.
+    static vector<ShardTable *> *the_tables = new vector<ShardTable *>;
+    return *the_tables;
+}
+
+size_t
+ShardTable::allocSlot()
+{
+    // Slots of destroyed stats are not reused, stats are seldom
+    // destroyed before the end of the simulation.
+    static atomic<size_t> nextSlot(0);
+    return nextSlot++;
+}
+
+ShardTable &
+ShardTable::create()
+{
+    ShardTable *table = new ShardTable;
+    lock_guard<mutex> lock(tablesMutex);
+    tables().push_back(table);
+    _local = table;
+    return *table;
+}
+
+void
+mergeDist(DistData &data, const DistData &other)
+{
+    // histograms are not merged, their buckets depend on the samples
+    assert(data.type == other.type && data.type != Hist);
+
+    data.sum += other.sum;
+    data.squares += other.squares;
+    data.samples += other.samples;
+    if (data.type == Deviation)
+        return;
+
+    assert(data.cvec.size() == other.cvec.size());
+    data.min_val = std::min(data.min_val, other.min_val);
+    data.max_val = std::max(data.max_val, other.max_val);
+    data.underflow += other.underflow;
+    data.overflow += other.overflow;
+    for (off_type i = 0; i < data.cvec.size(); ++i)
+        data.cvec[i] += other.cvec[i];
+}
+
 Formula::Formula()
 {
 }
@@ -448,6 +527,18 @@ Formula::reset()
 {
 }
 
+bool
+Formula::hasStatLeaf() const
+{
+    return root && root->hasStatLeaf();
+}
+
+bool
+Formula::untouched() const
+{
+    return hasStatLeaf() && root->untouched();
+}
+
 bool
 Formula::zero() const
 {
@@ -60,6 +60,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -71,6 +72,7 @@
 #include "base/intmath.hh"
 #include "base/str.hh"
 #include "base/types.hh"
+#include "config/use_sharded_stats.hh"
 
 class Callback;
 
@@ -1083,7 +1085,7 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
     zero() const
     {
         for (off_type i = 0; i < size(); ++i)
-            if (data(i)->zero())
+            if (!data(i)->zero())
                 return false;
         return true;
     }
@@ -1293,13 +1295,10 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
     bool
     zero() const
     {
-        return data(0)->zero();
-#if 0
         for (off_type i = 0; i < size(); ++i)
             if (!data(i)->zero())
                 return false;
         return true;
-#endif
     }
 
     /**
@@ -1812,6 +1811,237 @@ class AvgSampleStor
     }
 };
 
+//////////////////////////////////////////////////////////////////////
+//
+// Sharded Storage
+//
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * Per-thread storage of the stats that use ShardedStor. Every element
+ * of a sharded stat gets a slot, which holds in the table of every
+ * thread the storage of the updates made by that thread. Tables are
+ * created the first time a thread updates a sharded stat and are
+ * never destroyed, so their contents survive the thread.
+ */
+class ShardTable
+{
+  public:
+    /** Storage of every slot, null until the thread uses the slot */
+    std::vector<void *> slots;
+
+    /** The table of the calling thread. */
+    static ShardTable &
+    local()
+    {
+        return _local ? *_local : create();
+    }
+
+    /** Allocate the slot of a new stat element. */
+    static size_t allocSlot();
+
+    /**
+     * Call a function on the table of every thread. Tables must not be
+     * updated meanwhile, which holds when the stats are dumped or
+     * reset since the simulation threads are stopped at a barrier.
+     */
+    template <class F>
+    static void
+    forEach(F f)
+    {
+        std::lock_guard<std::mutex> lock(tablesMutex);
+        for (ShardTable *table : tables())
+            f(*table);
+    }
+
+  private:
+    /** Create the table of the calling thread. */
+    static ShardTable &create();
+
+    /** The tables of all the threads, guarded by tablesMutex */
+    static std::vector<ShardTable *> &tables();
+    static std::mutex tablesMutex;
+    static __thread ShardTable *_local;
+};
+
+/** Add the data of a distribution to that of the same distribution. */
+void mergeDist(DistData &data, const DistData &other);
+
+/**
+ * Storage that keeps a copy of another storage per thread, so that
+ * the stats of objects simulated by different threads may be updated
+ * concurrently without locks or atomics. Updates go to the copy of
+ * the calling thread, the copies are merged when the stat is read and
+ * are all cleared on reset.
+ *
+ * Updates cost a lookup in the table of the calling thread on top of
+ * those of the wrapped storage. Stats are sharded per stat (e.g.,
+ * ShardedScalar) or, for all the counters and distributions, with the
+ * USE_SHARDED_STATS build option. Only storages that can be merged are
+ * supported: StatStor, DistStor and SampleStor.
+ */
+template <class Stor>
+class ShardedStor
+{
+  public:
+    typedef typename Stor::Params Params;
+
+  private:
+    /** Slot of this stat element in the per-thread tables */
+    const size_t slot;
+    /** The stat, which holds the parameters of the storage */
+    Info *info;
+
+    /** The copy in a table, if any */
+    Stor *
+    shard(const ShardTable &table) const
+    {
+        return slot < table.slots.size() ?
+            static_cast<Stor *>(table.slots[slot]) : nullptr;
+    }
+
+    /** Create the copy of the calling thread. */
+    Stor &
+    create(ShardTable &table) const
+    {
+        if (slot >= table.slots.size())
+            table.slots.resize(slot + 1, nullptr);
+        Stor *stor = new Stor(info);
+        table.slots[slot] = stor;
+        return *stor;
+    }
+
+    /** The copy of the calling thread. */
+    Stor &
+    local() const
+    {
+        ShardTable &table = ShardTable::local();
+        Stor *stor = shard(table);
+        return stor ? *stor : create(table);
+    }
+
+    /** Call a function on the copy of every thread. */
+    template <class F>
+    void
+    forEach(F f) const
+    {
+        ShardTable::forEach([this, &f](const ShardTable &table) {
+            Stor *stor = shard(table);
+            if (stor)
+                f(*stor);
+        });
+    }
+
+  public:
+    ShardedStor(Info *_info)
+        : slot(ShardTable::allocSlot()), info(_info)
+    { }
+
+    ~ShardedStor()
+    {
+        ShardTable::forEach([this](ShardTable &table) {
+            delete shard(table);
+            if (slot < table.slots.size())
+                table.slots[slot] = nullptr;
+        });
+    }
+
+    ShardedStor(const ShardedStor &) = delete;
+    ShardedStor &operator=(const ShardedStor &) = delete;
+
+    /**
+     * Set the value of the stat, the copies of the other threads are
+     * cleared.
+     */
+    void
+    set(Counter val)
+    {
+        forEach([this](Stor &stor) { stor.reset(info); });
+        local().set(val);
+    }
+
+    void inc(Counter val) { local().inc(val); }
+    void dec(Counter val) { local().dec(val); }
+    void sample(Counter val, int number) { local().sample(val, number); }
+
+    Counter
+    value() const
+    {
+        Counter total = Counter();
+        forEach([&total](const Stor &stor) { total += stor.value(); });
+        return total;
+    }
+
+    Result
+    result() const
+    {
+        Result total = 0.0;
+        forEach([&total](const Stor &stor) { total += stor.result(); });
+        return total;
+    }
+
+    size_type size() const { return local().size(); }
+
+    bool
+    zero() const
+    {
+        bool all_zero = true;
+        forEach([&all_zero](const Stor &stor) {
+            all_zero = all_zero && stor.zero();
+        });
+        return all_zero;
+    }
+
+    void
+    prepare(Info *info)
+    {
+        forEach([info](Stor &stor) { stor.prepare(info); });
+    }
+
+    void
+    prepare(Info *info, DistData &data)
+    {
+        // Copies without samples do not take part in the merge, their
+        // minimum and maximum values are meaningless.
+        Stor &own = local();
+        own.prepare(info, data);
+        bool merged = !own.zero();
+
+        DistData other;
+        forEach([&](Stor &stor) {
+            if (&stor == &own || stor.zero())
+                return;
+            if (!merged) {
+                stor.prepare(info, data);
+                merged = true;
+            } else {
+                stor.prepare(info, other);
+                mergeDist(data, other);
+            }
+        });
+    }
+
+    void
+    reset(Info *info)
+    {
+        forEach([info](Stor &stor) { stor.reset(info); });
+    }
+};
+
+/**
+ * Storage of the counters, distributions and standard deviations,
+ * which are sharded in builds with USE_SHARDED_STATS.
+ */
+#if USE_SHARDED_STATS
+typedef ShardedStor<StatStor> CounterStor;
+typedef ShardedStor<DistStor> DistributionStor;
+typedef ShardedStor<SampleStor> DeviationStor;
+#else
+typedef StatStor CounterStor;
+typedef DistStor DistributionStor;
+typedef SampleStor DeviationStor;
+#endif
+
 /**
  * Implementation of a distribution stat. The type of distribution is
  * determined by the Storage template. @sa ScalarBase
@@ -2090,6 +2320,20 @@ class Node
      *
      */
     virtual std::string str() const = 0;
+
+    /**
+     * Are all the stats used by this subtree untouched since the last
+     * reset? Unlike result(), nothing is evaluated. Subtrees that use
+     * no stats are, see hasStatLeaf().
+     */
+    virtual bool untouched() const = 0;
+
+    /**
+     * Does this subtree use a stat that counts events? Constants and
+     * Value stats, which sample state such as the simulated time or
+     * the clock frequency, don't.
+     */
+    virtual bool hasStatLeaf() const = 0;
 };
 
 /** Shared pointer to a function Node. */
@@ -2119,6 +2363,23 @@ class ScalarStatNode : public Node
      *
      */
     std::string str() const { return data->name; }
+
+    bool untouched() const { return data->untouched(); }
+    bool hasStatLeaf() const { return true; }
+};
+
+/**
+ * A Value stat in a formula. Values sample state rather than count
+ * events, so they don't make the formula touched, e.g., x / simSeconds
+ * is untouched as long as x is.
+ */
+class ValueStatNode : public ScalarStatNode
+{
+  public:
+    ValueStatNode(const ScalarInfo *d) : ScalarStatNode(d) {}
+
+    bool untouched() const { return true; }
+    bool hasStatLeaf() const { return false; }
 };
 
 template <class Stat>
@@ -2160,6 +2421,9 @@ class ScalarProxyNode : public Node
     {
         return proxy.str();
     }
+
+    bool untouched() const { return proxy.result() == 0; }
+    bool hasStatLeaf() const { return true; }
 };
 
 class VectorStatNode : public Node
@@ -2175,6 +2439,9 @@ class VectorStatNode : public Node
     size_type size() const { return data->size(); }
 
     std::string str() const { return data->name; }
+
+    bool untouched() const { return data->untouched(); }
+    bool hasStatLeaf() const { return true; }
 };
 
 template <class T>
@@ -2189,6 +2456,8 @@ class ConstNode : public Node
     Result total() const { return vresult[0]; };
     size_type size() const { return 1; }
     std::string str() const { return std::to_string(vresult[0]); }
+    bool untouched() const { return true; }
+    bool hasStatLeaf() const { return false; }
 };
 
 template <class T>
@@ -2222,6 +2491,9 @@ class ConstVectorNode : public Node
         tmp += ")";
         return tmp;
     }
+
+    bool untouched() const { return true; }
+    bool hasStatLeaf() const { return false; }
 };
 
 template <class Op>
@@ -2306,6 +2578,9 @@ class UnaryNode : public Node
     {
         return OpString<Op>::str() + l->str();
     }
+
+    bool untouched() const { return l->untouched(); }
+    bool hasStatLeaf() const { return l->hasStatLeaf(); }
 };
 
 template <class Op>
@@ -2403,6 +2678,9 @@ class BinaryNode : public Node
     {
         return csprintf("(%s %s %s)", l->str(), OpString<Op>::str(), r->str());
     }
+
+    bool untouched() const { return l->untouched() && r->untouched(); }
+    bool hasStatLeaf() const { return l->hasStatLeaf() || r->hasStatLeaf(); }
 };
 
 template <class Op>
@@ -2454,6 +2732,9 @@ class SumNode : public Node
     {
         return csprintf("total(%s)", l->str());
     }
+
+    bool untouched() const { return l->untouched(); }
+    bool hasStatLeaf() const { return l->hasStatLeaf(); }
 };
 
 
@@ -2472,10 +2753,10 @@ class SumNode : public Node
  * This is a simple scalar statistic, like a counter.
  * @sa Stat, ScalarBase, StatStor
  */
-class Scalar : public ScalarBase<Scalar, StatStor>
+class Scalar : public ScalarBase<Scalar, CounterStor>
 {
   public:
-    using ScalarBase<Scalar, StatStor>::operator=;
+    using ScalarBase<Scalar, CounterStor>::operator=;
 };
 
 /**
@@ -2496,7 +2777,7 @@ class Value : public ValueBase<Value>
  * A vector of scalar stats.
  * @sa Stat, VectorBase, StatStor
  */
-class Vector : public VectorBase<Vector, StatStor>
+class Vector : public VectorBase<Vector, CounterStor>
 {
 };
 
@@ -2512,7 +2793,7 @@ class AverageVector : public VectorBase<AverageVector, AvgStor>
  * A 2-Dimensional vecto of scalar stats.
  * @sa Stat, Vector2dBase, StatStor
  */
-class Vector2d : public Vector2dBase<Vector2d, StatStor>
+class Vector2d : public Vector2dBase<Vector2d, CounterStor>
 {
 };
 
@@ -2520,7 +2801,7 @@ class Vector2d : public Vector2dBase<Vector2d, StatStor>
  * A simple distribution stat.
  * @sa Stat, DistBase, DistStor
  */
-class Distribution : public DistBase<Distribution, DistStor>
+class Distribution : public DistBase<Distribution, DistributionStor>
 {
   public:
     /**
@@ -2571,7 +2852,8 @@ class Histogram : public DistBase<Histogram, HistStor>
  * Calculates the mean and variance of all the samples.
  * @sa DistBase, SampleStor
  */
-class StandardDeviation : public DistBase<StandardDeviation, SampleStor>
+class StandardDeviation
+    : public DistBase<StandardDeviation, DeviationStor>
 {
   public:
     /**
@@ -2607,7 +2889,8 @@ class AverageDeviation : public DistBase<AverageDeviation, AvgSampleStor>
  * A vector of distributions.
  * @sa VectorDistBase, DistStor
  */
-class VectorDistribution : public VectorDistBase<VectorDistribution, DistStor>
+class VectorDistribution
+    : public VectorDistBase<VectorDistribution, DistributionStor>
 {
   public:
     /**
@@ -2637,7 +2920,7 @@ class VectorDistribution : public VectorDistBase<VectorDistribution, DistStor>
  * @sa VectorDistBase, SampleStor
  */
 class VectorStandardDeviation
-    : public VectorDistBase<VectorStandardDeviation, SampleStor>
+    : public VectorDistBase<VectorStandardDeviation, DeviationStor>
 {
   public:
     /**
@@ -2678,6 +2961,94 @@ class VectorAverageDeviation
     }
 };
 
+/**
+ * A scalar stat that may be updated concurrently by the threads of a
+ * multi-threaded simulation.
+ * @sa Stat, ScalarBase, ShardedStor
+ */
+class ShardedScalar : public ScalarBase<ShardedScalar, ShardedStor<StatStor>>
+{
+  public:
+    using ScalarBase<ShardedScalar, ShardedStor<StatStor>>::operator=;
+};
+
+/**
+ * A vector of sharded scalar stats.
+ * @sa Stat, VectorBase, ShardedStor
+ */
+class ShardedVector : public VectorBase<ShardedVector, ShardedStor<StatStor>>
+{
+};
+
+/**
+ * A 2-Dimensional vector of sharded scalar stats.
+ * @sa Stat, Vector2dBase, ShardedStor
+ */
+class ShardedVector2d
+    : public Vector2dBase<ShardedVector2d, ShardedStor<StatStor>>
+{
+};
+
+/**
+ * A distribution stat that may be updated concurrently by the threads
+ * of a multi-threaded simulation.
+ * @sa Stat, DistBase, ShardedStor
+ */
+class ShardedDistribution
+    : public DistBase<ShardedDistribution, ShardedStor<DistStor>>
+{
+  public:
+    /**
+     * Set the parameters of this distribution. @sa DistStor::Params
+     * @param min The minimum value of the distribution.
+     * @param max The maximum value of the distribution.
+     * @param bkt The number of values in each bucket.
+     * @return A reference to this distribution.
+     */
+    ShardedDistribution &
+    init(Counter min, Counter max, Counter bkt)
+    {
+        DistStor::Params *params = new DistStor::Params;
+        params->min = min;
+        params->max = max;
+        params->bucket_size = bkt;
+        params->buckets = (size_type)ceil((max - min + 1.0) / bkt);
+        this->setParams(params);
+        this->doInit();
+        return this->self();
+    }
+};
+
+/**
+ * A vector of sharded distributions.
+ * @sa VectorDistBase, ShardedStor
+ */
+class ShardedVectorDistribution
+    : public VectorDistBase<ShardedVectorDistribution, ShardedStor<DistStor>>
+{
+  public:
+    /**
+     * Initialize storage and parameters for this distribution.
+     * @param size The size of the vector (the number of distributions).
+     * @param min The minimum value of the distribution.
+     * @param max The maximum value of the distribution.
+     * @param bkt The number of values in each bucket.
+     * @return A reference to this distribution.
+     */
+    ShardedVectorDistribution &
+    init(size_type size, Counter min, Counter max, Counter bkt)
+    {
+        DistStor::Params *params = new DistStor::Params;
+        params->min = min;
+        params->max = max;
+        params->bucket_size = bkt;
+        params->buckets = (size_type)ceil((max - min + 1.0) / bkt);
+        this->setParams(params);
+        this->doInit(size);
+        return this->self();
+    }
+};
+
 template <class Stat>
 class FormulaInfoProxy : public InfoProxy<Stat, FormulaInfo>
 {
@@ -2685,17 +3056,48 @@ class FormulaInfoProxy : public InfoProxy<Stat, FormulaInfo>
     mutable VResult vec;
     mutable VCounter cvec;
 
+    /**
+     * Is vec the result since the last prepare()? Outputs may ask for
+     * the result more than once per dump (e.g., through zero()), the
+     * formula is only evaluated the first time.
+     */
+    mutable bool evaluated;
+
   public:
-    FormulaInfoProxy(Stat &stat) : InfoProxy<Stat, FormulaInfo>(stat) {}
+    FormulaInfoProxy(Stat &stat)
+        : InfoProxy<Stat, FormulaInfo>(stat), evaluated(false)
+    {}
 
     size_type size() const { return this->s.size(); }
 
+    void
+    prepare()
+    {
+        evaluated = false;
+        this->s.prepare();
+    }
+
     const VResult &
     result() const
     {
-        this->s.result(vec);
+        if (!evaluated) {
+            this->s.result(vec);
+            evaluated = true;
+        }
         return vec;
     }
+
+    bool
+    zero() const
+    {
+        for (Result r : result())
+            if (r != 0.0)
+                return false;
+        return true;
+    }
+
+    bool untouched() const { return this->s.untouched(); }
+
     Result total() const { return this->s.total(); }
     VCounter &value() const { return cvec; }
 
@@ -2971,6 +3373,20 @@ class Formula : public DataWrapVec<Formula, FormulaInfoProxy>
      */
     bool zero() const;
 
+    /**
+     * Does the formula use a stat that counts events, see
+     * Node::hasStatLeaf()?
+     */
+    bool hasStatLeaf() const;
+
+    /**
+     * Does the formula use a stat that counts events, and are all
+     * those stats untouched since the last reset? The formula is not
+     * evaluated. Formulas of constants and Value stats only, e.g.,
+     * simSeconds, are never untouched.
+     */
+    bool untouched() const;
+
     std::string str() const;
 };
 
@@ -2988,6 +3404,13 @@ class FormulaNode : public Node
     Result total() const { return formula.total(); }
 
     std::string str() const { return formula.str(); }
+    bool
+    untouched() const
+    {
+        return !formula.hasStatLeaf() || formula.untouched();
+    }
+
+    bool hasStatLeaf() const { return formula.hasStatLeaf(); }
 };
 
 /**
@@ -3031,11 +3454,11 @@ class Temp
     { }
 
     /**
-     * Create a new ScalarStatNode.
+     * Create a new ValueStatNode.
      * @param s The ScalarStat to place in a node.
      */
     Temp(const Value &s)
-        : node(new ScalarStatNode(s.info()))
+        : node(new ValueStatNode(s.info()))
     { }
 
     /**
@@ -3265,6 +3688,21 @@ void processDumpQueue();
 
 std::list<Info *> &statsList();
 
+/**
+ * Stats in the order dumps visit them, which is set once the stats
+ * are enabled.
+ */
+std::vector<Info *> &dumpOrder();
+
+/** Prepare every stat for a dump */
+void prepareAll();
+
+/**
+ * Visit every stat with an output, in dump order. Sparse outputs
+ * skip the stats that are untouched since the last reset.
+ */
+void dumpTo(Output &output);
+
 typedef std::map<const void *, Info *> MapType;
 MapType &statsMap();
 
@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/async.hh"
+
+#include <map>
+#include <string>
+
+#include "base/stats/info.hh"
+
+using namespace std;
+
+namespace Stats {
+
+namespace {
+
+/**
+ * Copy of a stat, with the values it had when it was copied. The
+ * copy of the base class keeps the name, flags, etc., and the data
+ * that prepare() stored in the info (distributions, 2d vectors).
+ * Copies are refreshed in place by later dumps to reuse their
+ * storage.
+ */
+template <class Base>
+class Frozen : public Base
+{
+  private:
+    bool _zero;
+
+  public:
+    Frozen(const Base &info)
+        : Base(info), _zero(info.zero())
+    {
+    }
+
+    void
+    refresh(const Base &info)
+    {
+        Base::operator=(info);
+        _zero = info.zero();
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return _zero; }
+    void visit(Output &visitor) override { visitor.visit(*this); }
+};
+
+/** Prerequisite of a frozen stat, only tells whether it was zero */
+class FrozenPrereq : public Info
+{
+  private:
+    bool _zero;
+
+  public:
+    FrozenPrereq(const Info &info)
+        : Info(info), _zero(info.zero())
+    {
+    }
+
+    void refresh(const Info &info) { _zero = info.zero(); }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return _zero; }
+    void visit(Output &visitor) override {}
+};
+
+class FrozenScalar : public Frozen<ScalarInfo>
+{
+  private:
+    Counter _value;
+    Result _result;
+    Result _total;
+
+  public:
+    FrozenScalar(const ScalarInfo &info)
+        : Frozen<ScalarInfo>(info), _value(info.value()),
+          _result(info.result()), _total(info.total())
+    {
+    }
+
+    void
+    refresh(const ScalarInfo &info)
+    {
+        Frozen<ScalarInfo>::refresh(info);
+        _value = info.value();
+        _result = info.result();
+        _total = info.total();
+    }
+
+    Counter value() const override { return _value; }
+    Result result() const override { return _result; }
+    Result total() const override { return _total; }
+};
+
+template <class Base>
+class FrozenVectorBase : public Frozen<Base>
+{
+  private:
+    VCounter _value;
+    VResult _result;
+    Result _total;
+
+  public:
+    FrozenVectorBase(const Base &info)
+        : Frozen<Base>(info), _value(info.value()),
+          _result(info.result()), _total(info.total())
+    {
+    }
+
+    void
+    refresh(const Base &info)
+    {
+        Frozen<Base>::refresh(info);
+        _value = info.value();
+        _result = info.result();
+        _total = info.total();
+    }
+
+    size_type size() const override { return _result.size(); }
+    const VCounter &value() const override { return _value; }
+    const VResult &result() const override { return _result; }
+    Result total() const override { return _total; }
+};
+
+typedef FrozenVectorBase<VectorInfo> FrozenVector;
+
+class FrozenFormula : public FrozenVectorBase<FormulaInfo>
+{
+  private:
+    string _str;
+
+  public:
+    FrozenFormula(const FormulaInfo &info)
+        : FrozenVectorBase<FormulaInfo>(info), _str(info.str())
+    {
+    }
+
+    void
+    refresh(const FormulaInfo &info)
+    {
+        FrozenVectorBase<FormulaInfo>::refresh(info);
+        _str = info.str();
+    }
+
+    string str() const override { return _str; }
+};
+
+class FrozenVectorDist : public Frozen<VectorDistInfo>
+{
+  private:
+    size_type _size;
+
+  public:
+    FrozenVectorDist(const VectorDistInfo &info)
+        : Frozen<VectorDistInfo>(info), _size(info.size())
+    {
+    }
+
+    void
+    refresh(const VectorDistInfo &info)
+    {
+        Frozen<VectorDistInfo>::refresh(info);
+        _size = info.size();
+    }
+
+    size_type size() const override { return _size; }
+};
+
+class FrozenVector2d : public Frozen<Vector2dInfo>
+{
+  private:
+    Result _total;
+
+  public:
+    FrozenVector2d(const Vector2dInfo &info)
+        : Frozen<Vector2dInfo>(info), _total(info.total())
+    {
+    }
+
+    void
+    refresh(const Vector2dInfo &info)
+    {
+        Frozen<Vector2dInfo>::refresh(info);
+        _total = info.total();
+    }
+
+    Result total() const override { return _total; }
+};
+
+/**
+ * Refresh the copy of a stat in a slot of a snapshot, or make a new
+ * copy if the slot is empty or holds another kind of stat.
+ */
+template <class FrozenType, class InfoType>
+FrozenType *
+freezeSlot(vector<unique_ptr<Info>> &slots, size_t slot,
+           const InfoType &info)
+{
+    if (slot == slots.size())
+        slots.emplace_back();
+
+    FrozenType *frozen = dynamic_cast<FrozenType *>(slots[slot].get());
+    if (frozen) {
+        frozen->refresh(info);
+    } else {
+        frozen = new FrozenType(info);
+        slots[slot].reset(frozen);
+    }
+    return frozen;
+}
+
+/** Asynchronous wrapper of every output */
+map<Output *, AsyncOutput *> &
+asyncOutputs()
+{
+    static map<Output *, AsyncOutput *> outputs;
+    return outputs;
+}
+
+} // anonymous namespace
+
+AsyncOutput::AsyncOutput(Output *_output, unsigned _depth)
+    : output(_output), depth(_depth), numStats(0), numPrereqs(0),
+      stopping(false),
+      lastValid(_output->valid())
+{
+}
+
+AsyncOutput::~AsyncOutput()
+{
+    flush();
+}
+
+template <class FrozenType, class InfoType>
+void
+AsyncOutput::freeze(const InfoType &info)
+{
+    FrozenType *frozen =
+        freezeSlot<FrozenType>(current.stats, numStats++, info);
+    if (info.prereq) {
+        frozen->prereq = freezeSlot<FrozenPrereq>(current.prereqs,
+                                                  numPrereqs++,
+                                                  *info.prereq);
+    }
+}
+
+void
+AsyncOutput::visit(const ScalarInfo &info)
+{
+    freeze<FrozenScalar>(info);
+}
+
+void
+AsyncOutput::visit(const VectorInfo &info)
+{
+    freeze<FrozenVector>(info);
+}
+
+void
+AsyncOutput::visit(const DistInfo &info)
+{
+    freeze<Frozen<DistInfo>>(info);
+}
+
+void
+AsyncOutput::visit(const VectorDistInfo &info)
+{
+    freeze<FrozenVectorDist>(info);
+}
+
+void
+AsyncOutput::visit(const Vector2dInfo &info)
+{
+    freeze<FrozenVector2d>(info);
+}
+
+void
+AsyncOutput::visit(const FormulaInfo &info)
+{
+    freeze<FrozenFormula>(info);
+}
+
+void
+AsyncOutput::visit(const SparseHistInfo &info)
+{
+    freeze<Frozen<SparseHistInfo>>(info);
+}
+
+bool
+AsyncOutput::valid() const
+{
+    return lastValid;
+}
+
+void
+AsyncOutput::begin()
+{
+    // reuse the storage of a dump that has been written
+    unique_lock<std::mutex> lock(queueMutex);
+    if (!spare.stats.empty())
+        current = std::move(spare);
+    numStats = 0;
+    numPrereqs = 0;
+}
+
+void
+AsyncOutput::end()
+{
+    current.stats.resize(numStats);
+    current.prereqs.resize(numPrereqs);
+
+    unique_lock<std::mutex> lock(queueMutex);
+    changed.wait(lock, [this]() { return queue.size() < depth; });
+    queue.push_back(std::move(current));
+    current = Snapshot();
+
+    if (!writer)
+        writer.reset(new thread(&AsyncOutput::write, this));
+    changed.notify_all();
+}
+
+void
+AsyncOutput::write()
+{
+    unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        changed.wait(lock, [this]() { return !queue.empty() || stopping; });
+        if (queue.empty())
+            return;
+
+        // the dump stays queued while it is written, so that it
+        // counts towards the depth of the queue
+        const Snapshot &dump = queue.front();
+        lock.unlock();
+
+        output->begin();
+        for (auto &info : dump.stats)
+            info->visit(*output);
+        output->end();
+        lastValid = output->valid();
+
+        lock.lock();
+        spare = std::move(queue.front());
+        queue.pop_front();
+        changed.notify_all();
+    }
+}
+
+void
+AsyncOutput::flush()
+{
+    unique_lock<std::mutex> lock(queueMutex);
+    if (!writer)
+        return;
+
+    stopping = true;
+    changed.notify_all();
+    lock.unlock();
+
+    writer->join();
+    writer.reset();
+    stopping = false;
+}
+
+Output *
+initAsync(Output *output)
+{
+    // enough for the writer to absorb bursts of dumps without holding
+    // many copies of the stats
+    const unsigned depth = 4;
+
+    AsyncOutput *&async = asyncOutputs()[output];
+    if (!async)
+        async = new AsyncOutput(output, depth);
+    return async;
+}
+
+void
+flushAsync()
+{
+    for (auto &async : asyncOutputs())
+        async.second->flush();
+}
+
+} // namespace Stats
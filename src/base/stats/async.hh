@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Stats output that writes dumps on a background thread.
+ */
+
+#ifndef __BASE_STATS_ASYNC_HH__
+#define __BASE_STATS_ASYNC_HH__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/stats/output.hh"
+
+namespace Stats {
+
+class Info;
+
+/**
+ * Wrap another output and write its dumps on a writer thread.
+ *
+ * When visited, every stat is copied along with its current values
+ * into a snapshot, which is replayed on the wrapped output by the
+ * writer thread, so the output is the same as if it was written
+ * synchronously. Formatting and I/O are taken off the simulation
+ * thread. At most a given number of dumps are queued, dumping
+ * blocks until the writer catches up beyond that.
+ *
+ * The writer thread is started by the first dump and stopped by
+ * flush(), which must be called before forking the simulator and
+ * before exiting.
+ */
+class AsyncOutput : public Output
+{
+  protected:
+    struct Snapshot
+    {
+        /** Copies of the stats in the order they were visited */
+        std::vector<std::unique_ptr<Info>> stats;
+        /** Copies of their prerequisites */
+        std::vector<std::unique_ptr<Info>> prereqs;
+    };
+
+    /** The output the dumps are written to */
+    Output *output;
+
+    /** Maximum number of dumps waiting to be written */
+    const unsigned depth;
+
+    /** Snapshot of the dump being visited */
+    Snapshot current;
+
+    /** Copies of stats and prerequisites in the current snapshot */
+    size_t numStats;
+    size_t numPrereqs;
+
+    /** Snapshot of a written dump, reused by the next dump */
+    Snapshot spare;
+
+    /** Dumps waiting to be written, oldest first */
+    std::deque<Snapshot> queue;
+
+    /** Should the writer thread stop once the queue is empty */
+    bool stopping;
+
+    /** Was the wrapped output valid after the last dump */
+    std::atomic<bool> lastValid;
+
+    std::mutex queueMutex;
+    std::condition_variable changed;
+    std::unique_ptr<std::thread> writer;
+
+    /** Body of the writer thread */
+    void write();
+
+    /** Add a copy of a stat and of its prerequisite to the snapshot */
+    template <class FrozenType, class InfoType>
+    void freeze(const InfoType &info);
+
+  public:
+    AsyncOutput(Output *output, unsigned depth);
+    ~AsyncOutput();
+
+    /** Write the queued dumps and stop the writer thread */
+    void flush();
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override;
+    bool canBeSparse() const override { return output->canBeSparse(); }
+    void begin() override;
+    void end() override;
+};
+
+/** Write the dumps of an output on a writer thread */
+Output *initAsync(Output *output);
+
+/** Flush all the outputs written on writer threads */
+void flushAsync();
+
+} // namespace Stats
+
+#endif // __BASE_STATS_ASYNC_HH__
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <ostream>
+#include <string>
+
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+
+using namespace std;
+
+namespace Stats {
+
+const uint32_t Binary::version;
+
+Binary::Binary()
+    : stream(NULL), schemaDone(false)
+{
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+bool
+Binary::noOutput(const Info &info) const
+{
+    // unlike the text output, stats are written whether they are
+    // zero or not to keep the same columns in every dump
+    return !info.flags.isSet(display);
+}
+
+void
+Binary::add(const string &name, const string &desc, double value)
+{
+    if (!schemaDone) {
+        names.push_back(name);
+        descs.push_back(desc);
+    }
+    record.push_back(value);
+}
+
+void
+Binary::addVector(const string &base, const string &desc,
+                  const vector<string> &subnames,
+                  const vector<string> &subdescs,
+                  const VResult &vec)
+{
+    if (schemaDone) {
+        record.insert(record.end(), vec.begin(), vec.end());
+        return;
+    }
+
+    for (off_type i = 0; i < vec.size(); ++i) {
+        const bool sub = i < subnames.size() && !subnames[i].empty();
+        const bool subdesc = i < subdescs.size() && !subdescs[i].empty();
+        add(base + (sub ? subnames[i] : to_string(i)),
+            subdesc ? subdescs[i] : desc, vec[i]);
+    }
+}
+
+void
+Binary::addDist(const string &base, const string &desc,
+                const DistData &data)
+{
+    add(base + "samples", desc, data.samples);
+    add(base + "sum", desc, data.sum);
+    add(base + "squares", desc, data.squares);
+    if (data.type == Hist)
+        add(base + "logs", desc, data.logs);
+
+    if (data.type == Deviation)
+        return;
+
+    add(base + "min_bucket", desc, data.min);
+    add(base + "bucket_size", desc, data.bucket_size);
+    if (data.type == Dist) {
+        add(base + "underflows", desc, data.underflow);
+        add(base + "overflows", desc, data.overflow);
+        add(base + "min_value", desc, data.min_val);
+        add(base + "max_value", desc, data.max_val);
+    }
+
+    if (schemaDone) {
+        record.insert(record.end(), data.cvec.begin(), data.cvec.end());
+        return;
+    }
+
+    for (off_type i = 0; i < data.cvec.size(); ++i)
+        add(base + "bucket" + to_string(i), desc, data.cvec[i]);
+}
+
+void
+Binary::begin()
+{
+    if (sparse)
+        fatal("Binary stats have the same columns in every dump, they "
+              "cannot be sparse\n");
+
+    record.clear();
+}
+
+template <class T>
+static void
+writeRaw(ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void
+writeString(ostream &stream, const string &str)
+{
+    writeRaw(stream, (uint32_t)str.size());
+    stream.write(str.data(), str.size());
+}
+
+void
+Binary::writeSchema()
+{
+    stream->write("gem5stat", 8);
+    writeRaw(*stream, version);
+    writeRaw(*stream, (uint32_t)names.size());
+    uint64_t size = 16;
+    for (off_type i = 0; i < names.size(); ++i) {
+        writeString(*stream, names[i]);
+        writeString(*stream, descs[i]);
+        size += 8 + names[i].size() + descs[i].size();
+    }
+
+    // align the records for readers that map the file
+    for (; size % sizeof(double); ++size)
+        stream->put(0);
+}
+
+void
+Binary::writeRecord()
+{
+    stream->write(reinterpret_cast<const char *>(record.data()),
+                  record.size() * sizeof(double));
+    stream->flush();
+}
+
+void
+Binary::end()
+{
+    if (!schemaDone) {
+        writeSchema();
+        schemaDone = true;
+    } else if (record.size() != names.size()) {
+        panic("Binary stats dump has %d values but %d columns\n",
+              record.size(), names.size());
+    }
+
+    writeRecord();
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    add(info.name, info.desc, info.result());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    const string base = schemaDone ? string() :
+        info.name + info.separatorString;
+    const VResult &vec = info.result();
+    // single values (e.g., most formulas) are named like scalars
+    if (vec.size() == 1)
+        add(info.name, info.desc, vec[0]);
+    else
+        addVector(base, info.desc, info.subnames, info.subdescs, vec);
+    if (info.flags.isSet(total))
+        add(base + "total", info.desc, info.total());
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    if (schemaDone) {
+        record.insert(record.end(), info.cvec.begin(), info.cvec.end());
+    } else {
+        const vector<string> no_subdescs;
+        for (off_type i = 0; i < info.x; ++i) {
+            const bool sub = i < info.subnames.size() &&
+                !info.subnames[i].empty();
+            const VResult yvec(info.cvec.begin() + i * info.y,
+                               info.cvec.begin() + (i + 1) * info.y);
+            addVector(info.name + "_" +
+                      (sub ? info.subnames[i] : to_string(i)) +
+                      info.separatorString,
+                      info.desc, info.y_subnames, no_subdescs, yvec);
+        }
+    }
+
+    if (info.flags.isSet(total))
+        add(info.name + info.separatorString + "total", info.desc,
+            info.total());
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    addDist(schemaDone ? string() : info.name + info.separatorString,
+            info.desc, info.data);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.size(); ++i) {
+        if (schemaDone) {
+            addDist(string(), string(), info.data[i]);
+            continue;
+        }
+
+        const bool sub = i < info.subnames.size() &&
+            !info.subnames[i].empty();
+        const bool subdesc = i < info.subdescs.size() &&
+            !info.subdescs[i].empty();
+        addDist(info.name + "_" + (sub ? info.subnames[i] : to_string(i)) +
+                info.separatorString,
+                subdesc ? info.subdescs[i] : info.desc, info.data[i]);
+    }
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    // sparse histograms have no fixed set of columns
+}
+
+Output *
+initBinary(const string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        binary.open(*simout.findOrCreate(filename, true)->stream());
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace Stats
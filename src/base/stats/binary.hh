@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Binary columnar stats output.
+ *
+ * The file starts with a schema naming every column, followed by one
+ * record per dump that packs the value of every column as a native
+ * double. The set of stats is fixed once the stats are enabled, so
+ * every record has the same size and the file can be read as a
+ * (dumps x columns) array:
+ *
+ *   char magic[8] = "gem5stat"
+ *   uint32_t version, columns
+ *   columns x { uint32_t length; char name[length];
+ *               uint32_t length; char desc[length]; }
+ *   padding to a multiple of 8 bytes
+ *   dumps x { double value[columns]; }
+ *
+ * Distributions are written as their raw data (samples, sum, squares,
+ * buckets, etc.) rather than as the derived values of the text
+ * output. Sparse histograms have no fixed set of columns and are not
+ * written. m5.stats.binary reads the files.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+struct DistData;
+
+class Binary : public Output
+{
+  protected:
+    std::ostream *stream;
+
+    /** Has the schema been written */
+    bool schemaDone;
+
+    /** Name and description of every column of the schema */
+    std::vector<std::string> names;
+    std::vector<std::string> descs;
+
+    /** Values of the current dump */
+    std::vector<double> record;
+
+    bool noOutput(const Info &info) const;
+
+    /** Add a column to the current dump */
+    void add(const std::string &name, const std::string &desc,
+             double value);
+
+    void addVector(const std::string &base, const std::string &desc,
+                   const std::vector<std::string> &subnames,
+                   const std::vector<std::string> &subdescs,
+                   const VResult &vec);
+    void addDist(const std::string &base, const std::string &desc,
+                 const DistData &data);
+
+    /** Write the schema, once the first dump has named the columns */
+    void writeSchema();
+    /** Write the values of the current dump */
+    virtual void writeRecord();
+
+  public:
+    static const uint32_t version = 1;
+
+    Binary();
+
+    void open(std::ostream &stream);
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override;
+    /** Every dump has the same columns */
+    bool canBeSparse() const override { return false; }
+    void begin() override;
+    void end() override;
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
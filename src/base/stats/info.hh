@@ -128,6 +128,15 @@ class Info
      */
     virtual bool zero() const = 0;
 
+    /**
+     * Has the stat been left untouched since the last reset? Stats
+     * are untouched when their storage holds its reset value, which
+     * costs nothing to track. Formulas are untouched when they use
+     * stats that count events and all of those are untouched, and are
+     * not evaluated to find out.
+     */
+    virtual bool untouched() const { return zero(); }
+
     /**
      * Visitor entry for outputing statistics data
      */
@@ -47,10 +47,16 @@ class SparseHistInfo; // Sparse histogram
 
 struct Output
 {
+    /** Leave out the stats that are untouched since the last reset */
+    bool sparse;
+
+    Output() : sparse(false) {}
     virtual ~Output() {}
     virtual void begin() = 0;
     virtual void end() = 0;
     virtual bool valid() const = 0;
+    /** Can the output leave out untouched stats */
+    virtual bool canBeSparse() const { return true; }
 
     virtual void visit(const ScalarInfo &info) = 0;
     virtual void visit(const VectorInfo &info) = 0;
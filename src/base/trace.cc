@@ -40,8 +40,11 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "base/debug.hh"
+#include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/output.hh"
 #include "base/str.hh"
@@ -99,14 +102,80 @@ disable()
     Debug::SimpleFlag::disableAll();
 }
 
-ObjectMatch ignore;
+bool filtering = false;
+
+namespace {
+
+/** Expressions given to select() and ignore() */
+std::vector<std::string> selected;
+std::vector<std::string> ignored;
+
+ObjectMatch selectMatch;
+ObjectMatch ignoreMatch;
+
+/** Every ObjectName, to update them when the filters change */
+std::unordered_set<ObjectName *> &
+objectNames()
+{
+    static std::unordered_set<ObjectName *> names;
+    return names;
+}
 
 void
-Logger::dump(Tick when, const std::string &name, const void *d, int len)
+updateFilters()
+{
+    selectMatch.setExpression(selected);
+    ignoreMatch.setExpression(ignored);
+    filtering = !selected.empty() || !ignored.empty();
+
+    for (ObjectName *name : objectNames())
+        name->traced = traced(static_cast<const std::string &>(*name));
+}
+
+} // anonymous namespace
+
+ObjectName::ObjectName(const std::string &name)
+    : std::string(name),
+      traced(Trace::traced(static_cast<const std::string &>(*this)))
+{
+    objectNames().insert(this);
+}
+
+ObjectName::ObjectName(const ObjectName &name)
+    : std::string(name), traced(name.traced)
+{
+    objectNames().insert(this);
+}
+
+ObjectName::~ObjectName()
+{
+    objectNames().erase(this);
+}
+
+bool
+matchObject(const std::string &name)
+{
+    return (selected.empty() || selectMatch.match(name)) &&
+        !ignoreMatch.match(name);
+}
+
+void
+select(const std::string &expr)
+{
+    selected.push_back(expr);
+    updateFilters();
+}
+
+void
+ignore(const std::string &expr)
 {
-    if (!name.empty() && ignore.match(name))
-        return;
+    ignored.push_back(expr);
+    updateFilters();
+}
 
+void
+Logger::dump(Tick when, const std::string &name, const void *d, int len)
+{
     const char *data = static_cast<const char *>(d);
     int c, i, j;
 
@@ -144,9 +213,6 @@ void
 OstreamLogger::logMessage(Tick when, const std::string &name,
                           const std::string &message)
 {
-    if (!name.empty() && ignore.match(name))
-        return;
-
     if (when != MaxTick)
         ccprintf(stream, "%7d: ", when);
 
@@ -157,4 +223,220 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     stream.flush();
 }
 
+const uint32_t BinaryLogger::version;
+const size_t BinaryLogger::blockSize;
+
+BinaryLogger::TextBuf::TextBuf(BinaryLogger &_logger)
+    : logger(_logger)
+{
+    setp(buf, buf + sizeof(buf));
+}
+
+BinaryLogger::TextBuf::int_type
+BinaryLogger::TextBuf::overflow(int_type c)
+{
+    sync();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+        sputc(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+}
+
+int
+BinaryLogger::TextBuf::sync()
+{
+    if (pptr() != pbase()) {
+        logger.begin(Text, MaxTick, std::string());
+        logger.putString(pbase(), pptr() - pbase());
+        logger.commit();
+        setp(buf, buf + sizeof(buf));
+    }
+    return 0;
+}
+
+BinaryLogger::BinaryLogger(std::ostream &_stream, size_t ring_size)
+    : stream(_stream),
+      ringBlocks(ring_size ?
+                 std::max<size_t>(2, divCeil(ring_size, blockSize)) : 0),
+      textBuf(*this), textStream(&textBuf)
+{
+    rawArgs = true;
+
+    names.emplace_back();
+    nameIds[std::string()] = 0;
+    for (auto &cached : nameCache)
+        cached.name = nullptr;
+
+    stream.write("gem5trc", 8);
+    stream.write(reinterpret_cast<const char *>(&version), sizeof(version));
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    flush();
+}
+
+void
+BinaryLogger::putString(const char *str, size_t length)
+{
+    put((uint32_t)length);
+    const size_t pos = record.size();
+    record.resize(pos + length);
+    std::memcpy(&record[pos], str, length);
+}
+
+uint32_t
+BinaryLogger::formatId(const char *format)
+{
+    // Formats are usually string literals, but check that the address
+    // was not reused by another string.
+    auto it = formatIds.find(format);
+    if (it != formatIds.end() && formats[it->second] == format)
+        return it->second;
+
+    const uint32_t id = formats.size();
+    formats.emplace_back(format);
+    formatIds[format] = id;
+    if (!ringBlocks)
+        define(FormatDef, id, formats.back(), true);
+    return id;
+}
+
+uint32_t
+BinaryLogger::nameId(const std::string &name)
+{
+    // Names are mostly the names of SimObjects, whose addresses do not
+    // change, so look them up by address first.
+    CachedName &cached =
+        nameCache[(reinterpret_cast<uintptr_t>(&name) >> 3) % nameCacheSize];
+    if (cached.name == &name && names[cached.id] == name)
+        return cached.id;
+
+    auto it = nameIds.find(name);
+    uint32_t id;
+    if (it != nameIds.end()) {
+        id = it->second;
+    } else {
+        id = names.size();
+        names.push_back(name);
+        nameIds[name] = id;
+        if (!ringBlocks)
+            define(NameDef, id, name, true);
+    }
+
+    cached.name = &name;
+    cached.id = id;
+    return id;
+}
+
+void
+BinaryLogger::begin(RecordType type, Tick when, const std::string &name)
+{
+    // The name must be defined before the record is started, the
+    // definition is a record of its own.
+    const uint32_t name_id = nameId(name);
+    record.clear();
+    put(type);
+    put((uint64_t)when);
+    put(name_id);
+}
+
+void
+BinaryLogger::commit()
+{
+    if (blocks.empty() ||
+        blocks.back().used + record.size() > blocks.back().size) {
+        if (!ringBlocks && !blocks.empty()) {
+            writeBlock(blocks.back());
+            blocks.back().used = 0;
+        } else if (ringBlocks && blocks.size() == ringBlocks) {
+            // drop the oldest records, reusing their block
+            blocks.push_back(std::move(blocks.front()));
+            blocks.pop_front();
+            blocks.back().used = 0;
+        } else {
+            blocks.emplace_back();
+            blocks.back().size = 0;
+            blocks.back().used = 0;
+        }
+
+        Block &block = blocks.back();
+        if (block.size < record.size()) {
+            block.size = std::max(blockSize, record.size());
+            block.data.reset(new char[block.size]);
+        }
+    }
+
+    Block &block = blocks.back();
+    std::memcpy(block.data.get() + block.used, record.data(), record.size());
+    block.used += record.size();
+}
+
+void
+BinaryLogger::define(RecordType type, uint32_t id, const std::string &str,
+                     bool buffered)
+{
+    // definitions may be added while a record is being encoded
+    std::vector<char> encoding;
+    record.swap(encoding);
+
+    put(type);
+    put(id);
+    putString(str.data(), str.size());
+    if (buffered)
+        commit();
+    else
+        stream.write(record.data(), record.size());
+
+    record.swap(encoding);
+}
+
+void
+BinaryLogger::writeBlock(Block &block)
+{
+    stream.write(block.data.get(), block.used);
+}
+
+void
+BinaryLogger::dump(Tick when, const std::string &name,
+                   const void *d, int len)
+{
+    begin(Dump, when, name);
+    putString(static_cast<const char *>(d), len);
+    commit();
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+                         const std::string &message)
+{
+    begin(Text, when, name);
+    putString(message.data(), message.size());
+    commit();
+}
+
+void
+BinaryLogger::flush()
+{
+    textStream.flush();
+
+    if (ringBlocks) {
+        // Only the records in the ring refer to the definitions, which
+        // are written first. The ring is emptied so that records are
+        // not written twice if it is flushed again.
+        for (uint32_t id = 1; id < names.size(); ++id)
+            define(NameDef, id, names[id], false);
+        for (uint32_t id = 0; id < formats.size(); ++id)
+            define(FormatDef, id, formats[id], false);
+
+        for (auto &block : blocks)
+            writeBlock(block);
+        blocks.clear();
+    } else if (!blocks.empty()) {
+        writeBlock(blocks.back());
+        blocks.back().used = 0;
+    }
+
+    stream.flush();
+}
+
 } // namespace Trace
@@ -36,7 +36,14 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <streambuf>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/cprintf.hh"
 #include "base/debug.hh"
@@ -51,22 +58,19 @@ namespace Trace {
 class Logger
 {
   protected:
-    /** Name match for objects to ignore */
-    ObjectMatch ignore;
+    /**
+     * Set by loggers that record the arguments of messages rather
+     * than formatted messages, see BinaryLogger.
+     */
+    bool rawArgs;
 
   public:
+    Logger() : rawArgs(false) { }
+
     /** Log a single message */
     template <typename ...Args>
     void dprintf(Tick when, const std::string &name, const char *fmt,
-                 const Args &...args)
-    {
-        if (!name.empty() && ignore.match(name))
-            return;
-
-        std::ostringstream line;
-        ccprintf(line, fmt, args...);
-        logMessage(when, name, line.str());
-    }
+                 const Args &...args);
 
     /** Dump a block of data of length len */
     virtual void dump(Tick when, const std::string &name,
@@ -83,8 +87,8 @@ class Logger
      *  way, or just set to one of std::cout, std::cerr */
     virtual std::ostream &getOstream() = 0;
 
-    /** Set objects to ignore */
-    void setIgnore(ObjectMatch &ignore_) { ignore = ignore_; }
+    /** Write out any buffered messages */
+    virtual void flush() { }
 
     virtual ~Logger() { }
 };
@@ -106,6 +110,276 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/**
+ * Logger that records messages in a compact binary form, to be
+ * rendered as text offline by util/trace_decoder. Messages are stored
+ * as the id of their format string and of their object name, the
+ * tick and the raw values of their arguments, so no formatting
+ * happens while simulating. Arguments of types that have no raw
+ * encoding (e.g., objects printed through operator<<) are formatted
+ * as strings.
+ *
+ * Records are written to the stream as they are logged, or, in flight
+ * recorder mode, kept in a ring buffer in memory of which only the
+ * last ring_size bytes are written when flush() is called: at exit and
+ * on panic() or fatal().
+ *
+ * The file starts with a header (char magic[8] = "gem5trc", uint32_t
+ * version) followed by records, each starting with its RecordType:
+ *
+ *   FormatDef, NameDef: uint32_t id, uint32_t length, char str[length]
+ *   Message: uint64_t tick, uint32_t name, uint32_t format,
+ *            uint8_t args, args x { char type, value }
+ *   Text, Dump: uint64_t tick, uint32_t name,
+ *               uint32_t length, char data[length]
+ *
+ * Argument types are Python struct codes (b, B, h, H, i, I, q, Q, ?,
+ * d) for integers, bools and doubles, c for chars, P for pointers
+ * (as uint64_t) and s for strings (uint32_t length, char str[length]).
+ * The name with id 0 is the empty name and a tick of MaxTick means
+ * that the message has no tick (DPRINTFR).
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    enum RecordType : uint8_t {
+        FormatDef = 1,
+        NameDef,
+        Message,
+        Text,
+        Dump,
+    };
+
+    static const uint32_t version = 1;
+
+  protected:
+    /** Records are buffered in blocks of this many bytes */
+    static const size_t blockSize = 64 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    /** Stream buffer turning the output of getOstream() into records */
+    class TextBuf : public std::streambuf
+    {
+      protected:
+        BinaryLogger &logger;
+        char buf[1024];
+
+        int_type overflow(int_type c) override;
+        int sync() override;
+
+      public:
+        TextBuf(BinaryLogger &logger);
+    };
+
+    std::ostream &stream;
+
+    /** Number of blocks kept in flight recorder mode, 0 otherwise */
+    const size_t ringBlocks;
+
+    /** Buffered blocks, oldest first, records are added to the last */
+    std::deque<Block> blocks;
+
+    /** Ids of the format strings, which are identified by address */
+    std::unordered_map<const char *, uint32_t> formatIds;
+    std::vector<std::string> formats;
+
+    /** Ids of the object names */
+    std::unordered_map<std::string, uint32_t> nameIds;
+    std::vector<std::string> names;
+
+    /** Last id looked up for an address of a name, by address */
+    static const size_t nameCacheSize = 256;
+    struct CachedName
+    {
+        const std::string *name;
+        uint32_t id;
+    } nameCache[nameCacheSize];
+
+    /** Record being encoded */
+    std::vector<char> record;
+
+    TextBuf textBuf;
+    std::ostream textStream;
+
+    /** Append a value to the record being encoded */
+    template <typename T>
+    void
+    put(const T &value)
+    {
+        const size_t pos = record.size();
+        record.resize(pos + sizeof(value));
+        std::memcpy(&record[pos], &value, sizeof(value));
+    }
+
+    void putString(const char *str, size_t length);
+
+    void putArg(char c) { put('c'); put(c); }
+    void putArg(signed char v) { put('b'); put(v); }
+    void putArg(unsigned char v) { put('B'); put(v); }
+    void putArg(short v) { put('h'); put(v); }
+    void putArg(unsigned short v) { put('H'); put(v); }
+    void putArg(int v) { put('i'); put(v); }
+    void putArg(unsigned int v) { put('I'); put(v); }
+    void putArg(long v) { put('q'); put((int64_t)v); }
+    void putArg(unsigned long v) { put('Q'); put((uint64_t)v); }
+    void putArg(long long v) { put('q'); put((int64_t)v); }
+    void putArg(unsigned long long v) { put('Q'); put((uint64_t)v); }
+    void putArg(bool v) { put('?'); put(v); }
+    void putArg(float v) { put('d'); put((double)v); }
+    void putArg(double v) { put('d'); put(v); }
+    void putArg(long double v) { put('d'); put((double)v); }
+    void putArg(const char *str) { put('s'); putString(str, strlen(str)); }
+    void putArg(char *str) { putArg((const char *)str); }
+    void
+    putArg(const std::string &str)
+    {
+        put('s');
+        putString(str.data(), str.size());
+    }
+
+    template <typename T>
+    void putArg(T *ptr) { put('P'); put((uint64_t)ptr); }
+
+    /**
+     * Anything else is logged as it prints, including enums, which
+     * may have their own operator<<.
+     */
+    template <typename T>
+    void
+    putArg(const T &v)
+    {
+        std::ostringstream str;
+        str << v;
+        putArg(str.str());
+    }
+
+    void putArgs() { }
+
+    template <typename T, typename ...Args>
+    void
+    putArgs(const T &arg, const Args &...args)
+    {
+        putArg(arg);
+        putArgs(args...);
+    }
+
+    uint32_t formatId(const char *format);
+    uint32_t nameId(const std::string &name);
+
+    /** Start a record of a message */
+    void begin(RecordType type, Tick when, const std::string &name);
+
+    /** Add a record to the current block */
+    void commit();
+
+    /**
+     * Add a definition of an id, to the buffered records or directly
+     * to the stream.
+     */
+    void define(RecordType type, uint32_t id, const std::string &str,
+                bool buffered);
+
+    /** Write out a block, in order */
+    void writeBlock(Block &block);
+
+  public:
+    /**
+     * @param stream Stream the records are written to.
+     * @param ring_size Size of the flight recorder, 0 to write every
+     *     record.
+     */
+    BinaryLogger(std::ostream &stream, size_t ring_size = 0);
+    ~BinaryLogger();
+
+    /** Log a message without formatting it */
+    template <typename ...Args>
+    void
+    log(Tick when, const std::string &name, const char *fmt,
+        const Args &...args)
+    {
+        begin(Message, when, name);
+        put(formatId(fmt));
+        put((uint8_t)sizeof...(args));
+        putArgs(args...);
+        commit();
+    }
+
+    void dump(Tick when, const std::string &name,
+              const void *d, int len) override;
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) override;
+
+    std::ostream &getOstream() override { return textStream; }
+
+    void flush() override;
+};
+
+template <typename ...Args>
+void
+Logger::dprintf(Tick when, const std::string &name, const char *fmt,
+                const Args &...args)
+{
+    if (rawArgs) {
+        static_cast<BinaryLogger *>(this)->log(when, name, fmt, args...);
+        return;
+    }
+
+    std::ostringstream line;
+    ccprintf(line, fmt, args...);
+    logMessage(when, name, line.str());
+}
+
+/**
+ * Name of a SimObject, which caches whether the messages of the object
+ * are logged, so that the trace macros check a flag rather than match
+ * the name against the objects to trace and to ignore. The flags are
+ * updated whenever these change. Other names are matched when their
+ * objects log a message.
+ */
+class ObjectName : public std::string
+{
+  public:
+    /** Are the messages of the object logged */
+    bool traced;
+
+    ObjectName(const std::string &name);
+    ObjectName(const ObjectName &name);
+    ~ObjectName();
+
+    ObjectName &operator=(const ObjectName &) = delete;
+};
+
+/** Are objects selected or ignored, see select() and ignore() */
+extern bool filtering;
+
+/** Match a name against the objects to trace and to ignore */
+bool matchObject(const std::string &name);
+
+/** Should the messages of an object be logged */
+inline bool
+traced(const std::string &name)
+{
+    return !filtering || name.empty() || matchObject(name);
+}
+
+inline bool traced(const ObjectName &name) { return name.traced; }
+
+/**
+ * Only log the messages of objects that match an expression (see
+ * ObjectMatch) given to select(), if any.
+ */
+void select(const std::string &expr);
+
+/** Do not log the messages of objects that match an expression */
+void ignore(const std::string &expr);
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -165,23 +439,34 @@ class Named
 
 #define DDUMP(x, data, count) do {                                        \
     using namespace Debug;                                                \
-    if (DTRACE(x))                                                        \
-        Trace::getDebugLogger()->dump(curTick(), name(), data, count);    \
+    if (DTRACE(x)) {                                                      \
+        const auto &trace_name_ = name();                                 \
+        if (Trace::traced(trace_name_)) {                                 \
+            Trace::getDebugLogger()->dump(curTick(), trace_name_,         \
+                data, count);                                             \
+        }                                                                 \
+    }                                                                     \
 } while (0)
 
 #define DPRINTF(x, ...) do {                                              \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), name(),               \
-            __VA_ARGS__);                                                 \
+        const auto &trace_name_ = name();                                 \
+        if (Trace::traced(trace_name_)) {                                 \
+            Trace::getDebugLogger()->dprintf(curTick(), trace_name_,      \
+                __VA_ARGS__);                                             \
+        }                                                                 \
     }                                                                     \
 } while (0)
 
 #define DPRINTFS(x, s, ...) do {                                          \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), s->name(),            \
-            __VA_ARGS__);                                                 \
+        const auto &trace_name_ = s->name();                              \
+        if (Trace::traced(trace_name_)) {                                 \
+            Trace::getDebugLogger()->dprintf(curTick(), trace_name_,      \
+                __VA_ARGS__);                                             \
+        }                                                                 \
     }                                                                     \
 } while (0)
 
@@ -194,11 +479,17 @@ class Named
 } while (0)
 
 #define DDUMPN(data, count) do {                                          \
-    Trace::getDebugLogger()->dump(curTick(), name(), data, count);        \
+    const auto &trace_name_ = name();                                     \
+    if (Trace::traced(trace_name_))                                       \
+        Trace::getDebugLogger()->dump(curTick(), trace_name_, data, count); \
 } while (0)
 
 #define DPRINTFN(...) do {                                                \
-    Trace::getDebugLogger()->dprintf(curTick(), name(), __VA_ARGS__);     \
+    const auto &trace_name_ = name();                                     \
+    if (Trace::traced(trace_name_)) {                                     \
+        Trace::getDebugLogger()->dprintf(curTick(), trace_name_,          \
+            __VA_ARGS__);                                                 \
+    }                                                                     \
 } while (0)
 
 #define DPRINTFNR(...) do {                                               \
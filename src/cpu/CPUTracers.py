@@ -35,6 +35,13 @@ class ExeTracer(InstTracer):
     cxx_class = 'Trace::ExeTracer'
     cxx_header = "cpu/exetrace.hh"
 
+class InstFlightRecorder(InstTracer):
+    type = 'InstFlightRecorder'
+    cxx_class = 'Trace::InstFlightRecorder'
+    cxx_header = "cpu/flight_recorder.hh"
+    size = Param.Unsigned(10000,
+        "Number of instructions to keep for each thread")
+
 class IntelTrace(InstTracer):
     type = 'IntelTrace'
     cxx_class = 'Trace::IntelTrace'
@@ -50,6 +50,7 @@
 #include <bitset>
 #include <deque>
 #include <list>
+#include <queue>
 #include <string>
 
 #include "arch/generic/tlb.hh"
@@ -59,6 +60,7 @@
 #include "cpu/checker/cpu.hh"
 #include "cpu/exec_context.hh"
 #include "cpu/exetrace.hh"
+#include "cpu/inst_pool.hh"
 #include "cpu/inst_res.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/comm.hh"
@@ -76,7 +78,8 @@
  */
 
 template <class Impl>
-class BaseDynInst : public ExecContext, public RefCounted
+class BaseDynInst : public ExecContext, public RefCounted,
+                    public InstPoolAllocated
 {
   public:
     // Typedef for the CPU.
@@ -88,9 +91,6 @@ class BaseDynInst : public ExecContext, public RefCounted
     typedef typename Impl::DynInstPtr DynInstPtr;
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
-    // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
-
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
         MaxInstDestRegs = TheISA::MaxInstDestRegs       /// Max dest regs
@@ -165,9 +165,11 @@ class BaseDynInst : public ExecContext, public RefCounted
 
   protected:
     /** The result of the instruction; assumes an instruction can have many
-     *  destination registers.
+     *  destination registers. Results are only recorded for the checker,
+     *  so the queue is backed by a list, which unlike a deque doesn't
+     *  allocate anything while empty.
      */
-    std::queue<InstResult> instResult;
+    std::queue<InstResult, std::list<InstResult>> instResult;
 
     /** PC state for this instruction. */
     TheISA::PCState pc;
@@ -187,9 +189,6 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
-    ListIt instListIt;
-
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
     TheISA::PCState predPC;
@@ -231,6 +230,9 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Store queue index. */
     int16_t sqIdx;
 
+    /** Instruction queue slot. */
+    int16_t iqSlot;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
@@ -877,12 +879,6 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Has this instruction generated a memory request. */
     bool hasRequest() { return instFlags[ReqMade]; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
-    ListIt &getInstListIt() { return instListIt; }
-
-    /** Sets iterator for this instruction in the list of all insts. */
-    void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
-
   public:
     /** Returns the number of consecutive store conditional failures. */
     unsigned int readStCondFailures() const
@@ -101,6 +101,7 @@ BaseDynInst<Impl>::initVars()
 
     lqIdx = -1;
     sqIdx = -1;
+    iqSlot = -1;
 
     // Eventually make this a parameter.
     threadNumber = 0;
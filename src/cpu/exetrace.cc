@@ -50,6 +50,48 @@ using namespace TheISA;
 
 namespace Trace {
 
+ExeTracerRecord::Format
+ExeTracerRecord::Format::fromFlags()
+{
+    Format fmt;
+    fmt.ticks = Debug::ExecTicks;
+    fmt.asid = Debug::ExecAsid;
+    fmt.thread = Debug::ExecThread;
+    fmt.symbol = Debug::ExecSymbol;
+    fmt.opClass = Debug::ExecOpClass;
+    fmt.result = Debug::ExecResult;
+    fmt.effAddr = Debug::ExecEffAddr;
+    fmt.fetchSeq = Debug::ExecFetchSeq;
+    fmt.cpSeq = Debug::ExecCPSeq;
+    fmt.flags = Debug::ExecFlags;
+    fmt.micro = Debug::ExecMicro;
+    fmt.macro = Debug::ExecMacro;
+    fmt.user = Debug::ExecUser;
+    fmt.kernel = Debug::ExecKernel;
+    return fmt;
+}
+
+ExeTracerRecord::Format
+ExeTracerRecord::Format::defaults()
+{
+    Format fmt;
+    fmt.ticks = true;
+    fmt.asid = false;
+    fmt.thread = true;
+    fmt.symbol = true;
+    fmt.opClass = true;
+    fmt.result = true;
+    fmt.effAddr = true;
+    fmt.fetchSeq = false;
+    fmt.cpSeq = false;
+    fmt.flags = false;
+    fmt.micro = true;
+    fmt.macro = true;
+    fmt.user = true;
+    fmt.kernel = true;
+    return fmt;
+}
+
 void
 ExeTracerRecord::dumpTicks(ostream &outs)
 {
@@ -57,31 +99,32 @@ ExeTracerRecord::dumpTicks(ostream &outs)
 }
 
 void
-Trace::ExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran)
+Trace::ExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran,
+                                  const Format &fmt)
 {
     ostream &outs = Trace::output();
 
-    if (!Debug::ExecUser || !Debug::ExecKernel) {
+    if (!fmt.user || !fmt.kernel) {
         bool in_user_mode = TheISA::inUserMode(thread);
-        if (in_user_mode && !Debug::ExecUser) return;
-        if (!in_user_mode && !Debug::ExecKernel) return;
+        if (in_user_mode && !fmt.user) return;
+        if (!in_user_mode && !fmt.kernel) return;
     }
 
-    if (Debug::ExecTicks)
+    if (fmt.ticks)
         dumpTicks(outs);
 
     outs << thread->getCpuPtr()->name() << " ";
 
-    if (Debug::ExecAsid)
+    if (fmt.asid)
         outs << "A" << dec << TheISA::getExecutingAsid(thread) << " ";
 
-    if (Debug::ExecThread)
+    if (fmt.thread)
         outs << "T" << thread->threadId() << " : ";
 
     std::string sym_str;
     Addr sym_addr;
     Addr cur_pc = pc.instAddr();
-    if (debugSymbolTable && Debug::ExecSymbol &&
+    if (debugSymbolTable && fmt.symbol &&
             (!FullSystem || !inUserMode(thread)) &&
             debugSymbolTable->findNearestSymbol(cur_pc, sym_str, sym_addr)) {
         if (cur_pc != sym_addr)
@@ -109,28 +152,28 @@ Trace::ExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran)
     if (ran) {
         outs << " : ";
 
-        if (Debug::ExecOpClass) {
+        if (fmt.opClass) {
             outs << Enums::OpClassStrings[inst->opClass()] << " : ";
         }
 
-        if (Debug::ExecResult && !predicate) {
+        if (fmt.result && !predicate) {
             outs << "Predicated False";
         }
 
-        if (Debug::ExecResult && data_status != DataInvalid) {
+        if (fmt.result && data_status != DataInvalid) {
             ccprintf(outs, " D=%#018x", data.as_int);
         }
 
-        if (Debug::ExecEffAddr && getMemValid())
+        if (fmt.effAddr && getMemValid())
             outs << " A=0x" << hex << addr;
 
-        if (Debug::ExecFetchSeq && fetch_seq_valid)
+        if (fmt.fetchSeq && fetch_seq_valid)
             outs << "  FetchSeq=" << dec << fetch_seq;
 
-        if (Debug::ExecCPSeq && cp_seq_valid)
+        if (fmt.cpSeq && cp_seq_valid)
             outs << "  CPSeq=" << dec << cp_seq;
 
-        if (Debug::ExecFlags) {
+        if (fmt.flags) {
             outs << "  flags=(";
             inst->printFlags(outs, "|");
             outs << ")";
@@ -144,7 +187,7 @@ Trace::ExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran)
 }
 
 void
-Trace::ExeTracerRecord::dump()
+Trace::ExeTracerRecord::dump(const Format &fmt)
 {
     /*
      * The behavior this check tries to achieve is that if ExecMacro is on,
@@ -154,15 +197,15 @@ Trace::ExeTracerRecord::dump()
      * finishes. Macroops then behave like regular instructions and don't
      * complete/print when they fault.
      */
-    if (Debug::ExecMacro && staticInst->isMicroop() &&
-        ((Debug::ExecMicro &&
+    if (fmt.macro && staticInst->isMicroop() &&
+        ((fmt.micro &&
             macroStaticInst && staticInst->isFirstMicroop()) ||
-            (!Debug::ExecMicro &&
+            (!fmt.micro &&
              macroStaticInst && staticInst->isLastMicroop()))) {
-        traceInst(macroStaticInst, false);
+        traceInst(macroStaticInst, false, fmt);
     }
-    if (Debug::ExecMicro || !staticInst->isMicroop()) {
-        traceInst(staticInst, true);
+    if (fmt.micro || !staticInst->isMicroop()) {
+        traceInst(staticInst, true, fmt);
     }
 }
 
@@ -54,9 +54,42 @@ class ExeTracerRecord : public InstRecord
     {
     }
 
-    void traceInst(const StaticInstPtr &inst, bool ran);
+    /**
+     * What to print about each instruction. ExeTracer takes this
+     * from the Exec* debug flags, other users may pick their own.
+     */
+    struct Format
+    {
+        bool ticks;
+        bool asid;
+        bool thread;
+        bool symbol;
+        bool opClass;
+        bool result;
+        bool effAddr;
+        bool fetchSeq;
+        bool cpSeq;
+        bool flags;
+        bool micro;
+        bool macro;
+        bool user;
+        bool kernel;
+
+        /** The format selected by the Exec* debug flags */
+        static Format fromFlags();
+        /** The format of the Exec compound flag */
+        static Format defaults();
+    };
+
+    void traceInst(const StaticInstPtr &inst, bool ran)
+    {
+        traceInst(inst, ran, Format::fromFlags());
+    }
+
+    void traceInst(const StaticInstPtr &inst, bool ran, const Format &fmt);
 
-    void dump();
+    void dump() { dump(Format::fromFlags()); }
+    void dump(const Format &fmt);
     virtual void dumpTicks(std::ostream &outs);
 };
 
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/flight_recorder.hh"
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+#include "base/trace.hh"
+#include "cpu/base.hh"
+#include "cpu/exetrace.hh"
+#include "cpu/thread_context.hh"
+#include "sim/core.hh"
+
+namespace Trace {
+
+namespace {
+
+/** Records freed on this thread, reused by the next instructions */
+__thread void *freeRecords = nullptr;
+
+/** Turns a stored record back into one ExeTracer can print */
+class FlightReplay : public ExeTracerRecord
+{
+  public:
+    FlightReplay(ThreadContext *tc, const FlightRecord &r)
+        : ExeTracerRecord(r.when, tc, r.staticInst, r.pc, r.macroStaticInst)
+    {
+        data.as_int = r.data;
+        data_status = static_cast<decltype(data_status)>(r.dataStatus);
+        addr = r.addr;
+        mem_valid = r.memValid;
+        predicate = r.predicate;
+    }
+};
+
+} // anonymous namespace
+
+void *
+InstFlightRecord::operator new(size_t size)
+{
+    assert(size == sizeof(InstFlightRecord));
+
+    if (void *p = freeRecords) {
+        freeRecords = *static_cast<void **>(p);
+        return p;
+    }
+
+    return ::operator new(size);
+}
+
+void
+InstFlightRecord::operator delete(void *p)
+{
+    *static_cast<void **>(p) = freeRecords;
+    freeRecords = p;
+}
+
+void
+InstFlightRecord::dump()
+{
+    FlightRecord &r = ring.push();
+    r.when = when;
+    r.pc = pc;
+    r.staticInst = staticInst;
+    r.macroStaticInst = macroStaticInst;
+    r.data = data.as_int;
+    r.addr = addr;
+    r.dataStatus = data_status;
+    r.memValid = mem_valid;
+    r.predicate = predicate;
+}
+
+InstFlightRecorder::InstFlightRecorder(const Params *p)
+    : InstTracer(p), size(p->size), lastThread(nullptr), lastRing(nullptr)
+{
+    if (size == 0)
+        fatal("%s: a flight recorder needs room for at least one "
+              "instruction\n", name());
+
+    registerFlightRecorder(
+        new MakeCallback<InstFlightRecorder, &InstFlightRecorder::dump>(
+            this));
+}
+
+FlightRing &
+InstFlightRecorder::findRing(ThreadContext *tc)
+{
+    for (auto &ring : rings) {
+        if (ring->thread == tc)
+            return *ring;
+    }
+
+    rings.emplace_back(new FlightRing(tc, size));
+    return *rings.back();
+}
+
+void
+InstFlightRecorder::dump()
+{
+    std::ostream &os = Trace::output();
+    const ExeTracerRecord::Format fmt(ExeTracerRecord::Format::defaults());
+
+    for (auto &ring : rings) {
+        const size_t count = ring->full ? size : ring->next;
+        if (count == 0)
+            continue;
+
+        ccprintf(os, "%s: last %d instructions of %s thread %d\n",
+                 name(), count, ring->thread->getCpuPtr()->name(),
+                 ring->thread->threadId());
+
+        size_t index = ring->full ? ring->next : 0;
+        for (size_t i = 0; i < count; ++i) {
+            FlightReplay(ring->thread, ring->records[index]).dump(fmt);
+            if (++index == size)
+                index = 0;
+        }
+    }
+
+    os.flush();
+}
+
+} // namespace Trace
+
+Trace::InstFlightRecorder *
+InstFlightRecorderParams::create()
+{
+    return new Trace::InstFlightRecorder(this);
+}
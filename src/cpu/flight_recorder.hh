@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_FLIGHT_RECORDER_HH__
+#define __CPU_FLIGHT_RECORDER_HH__
+
+#include <memory>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+#include "params/InstFlightRecorder.hh"
+#include "sim/insttracer.hh"
+
+class ThreadContext;
+
+namespace Trace {
+
+/**
+ * What ExeTracer would print about an instruction, kept in binary
+ * form until somebody asks for it.
+ */
+struct FlightRecord
+{
+    Tick when;
+    TheISA::PCState pc;
+    StaticInstPtr staticInst;
+    StaticInstPtr macroStaticInst;
+    uint64_t data;
+    Addr addr;
+    uint8_t dataStatus;
+    bool memValid;
+    bool predicate;
+};
+
+/**
+ * The last records of one thread. Once the ring has wrapped, next
+ * points at the oldest record.
+ */
+struct FlightRing
+{
+    FlightRing(ThreadContext *tc, size_t size)
+        : thread(tc), records(size), next(0), full(false)
+    {}
+
+    FlightRecord &
+    push()
+    {
+        FlightRecord &record = records[next];
+        if (++next == records.size()) {
+            next = 0;
+            full = true;
+        }
+        return record;
+    }
+
+    ThreadContext *const thread;
+    std::vector<FlightRecord> records;
+    size_t next;
+    bool full;
+};
+
+class InstFlightRecord : public InstRecord
+{
+  public:
+    InstFlightRecord(FlightRing &_ring, Tick _when, ThreadContext *_thread,
+                     const StaticInstPtr _staticInst, TheISA::PCState _pc,
+                     const StaticInstPtr _macroStaticInst = NULL)
+        : InstRecord(_when, _thread, _staticInst, _pc, _macroStaticInst),
+          ring(_ring)
+    {
+    }
+
+    /** Store the record in the ring of its thread */
+    void dump() override;
+
+    /**
+     * A record is allocated for every instruction, recycle them
+     * instead of going to the heap each time.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
+
+  private:
+    FlightRing &ring;
+};
+
+/**
+ * Keeps the last N instructions of each thread in a ring buffer and
+ * prints them in ExeTracer format only when asked to: on a panic or
+ * fatal error, on SIGHUP or from the dumptrace m5 op. Recording does
+ * not depend on the Exec debug flags, and is cheap enough to leave on
+ * for whole runs.
+ */
+class InstFlightRecorder : public InstTracer
+{
+  public:
+    typedef InstFlightRecorderParams Params;
+    InstFlightRecorder(const Params *p);
+
+    InstRecord *
+    getInstRecord(Tick when, ThreadContext *tc,
+            const StaticInstPtr staticInst, TheISA::PCState pc,
+            const StaticInstPtr macroStaticInst = NULL) override
+    {
+        if (tc != lastThread) {
+            lastRing = &findRing(tc);
+            lastThread = tc;
+        }
+
+        return new InstFlightRecord(*lastRing, when, tc,
+                staticInst, pc, macroStaticInst);
+    }
+
+    /** Print the recorded instructions of every thread, oldest first */
+    void dump();
+
+  private:
+    FlightRing &findRing(ThreadContext *tc);
+
+    /** Number of instructions kept per thread */
+    const size_t size;
+
+    std::vector<std::unique_ptr<FlightRing>> rings;
+
+    /** Ring of the thread that asked for a record last */
+    ThreadContext *lastThread;
+    FlightRing *lastRing;
+};
+
+} // namespace Trace
+
+#endif // __CPU_FLIGHT_RECORDER_HH__
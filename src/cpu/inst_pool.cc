@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/inst_pool.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+
+InstPool::InstPool(size_t block_size, size_t _capacity)
+    : stride(sizeof(Header) + roundUp(block_size, sizeof(Header))),
+      blockSize(block_size), capacity(std::max<size_t>(_capacity, 1)),
+      freeList(NULL), numBlocks(0)
+{
+    grow();
+}
+
+InstPool::~InstPool()
+{
+    for (char *chunk : chunks)
+        ::operator delete(chunk);
+}
+
+void
+InstPool::grow()
+{
+    numBlocks += capacity;
+
+    char *chunk = static_cast<char *>(::operator new(capacity * stride));
+    chunks.push_back(chunk);
+
+    // Link the blocks in address order
+    for (size_t i = capacity; i-- > 0; ) {
+        Header *header = reinterpret_cast<Header *>(chunk + i * stride);
+        header->next = freeList;
+        freeList = header;
+    }
+}
+
+void
+InstPool::regStats(const std::string &name)
+{
+    allocs
+        .name(name + ".allocs")
+        .desc("Number of dynamic instructions allocated from the pool")
+        ;
+
+    exhausted
+        .name(name + ".exhausted")
+        .desc("Number of times the pool ran out of blocks and grew")
+        ;
+
+    blocks
+        .scalar(numBlocks)
+        .name(name + ".blocks")
+        .desc("Number of blocks in the pool")
+        ;
+}
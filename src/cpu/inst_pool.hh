@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Recycled storage for dynamic instructions.
+ */
+
+#ifndef __CPU_INST_POOL_HH__
+#define __CPU_INST_POOL_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+
+/**
+ * Recycles the storage of the dynamic instructions of a CPU.
+ *
+ * Out-of-order and pipelined CPUs create a dynamic instruction for
+ * every fetched instruction, including the ones on wrong paths, and
+ * destroy it when its last reference goes away. The pool keeps the
+ * storage of destroyed instructions on a free list rather than
+ * returning it to the host heap, so the instructions in flight keep
+ * reusing the same, cache-warm memory.
+ *
+ * The pool starts with enough blocks for the instructions a CPU can
+ * have in flight, and grows by the same amount whenever it runs out,
+ * which is reported as a stat. Memory is only returned to the host
+ * when the pool is destroyed, so instructions must not outlive the
+ * pool (they can't outlive their CPU anyway).
+ *
+ * Every block starts with a header that points back to its pool, so
+ * that instructions can be deleted without knowing their pool. A
+ * dynamic instruction class uses the pool by deriving from
+ * InstPoolAllocated:
+ *
+ *   new (cpu->instPool) DynInst(...)
+ *
+ * Instructions allocated with a plain new expression bypass the pool
+ * and use the host heap. Pools aren't thread-safe, which is fine
+ * since a CPU only creates and destroys its instructions from the
+ * thread that services its event queue.
+ */
+class InstPool
+{
+  public:
+    /**
+     * @param block_size Size of the instructions, can't be exceeded.
+     * @param capacity Initial number of blocks and growth increment.
+     */
+    InstPool(size_t block_size, size_t capacity);
+    ~InstPool();
+
+    void regStats(const std::string &name);
+
+    /** Allocate storage for an instruction of at most blockSize bytes. */
+    void *
+    allocate(size_t size)
+    {
+        assert(size <= blockSize);
+
+        ++allocs;
+        if (!freeList) {
+            ++exhausted;
+            grow();
+        }
+
+        Header *header = freeList;
+        freeList = header->next;
+        header->pool = this;
+        return header + 1;
+    }
+
+    /**
+     * Allocate storage for an instruction on the host heap, for
+     * instructions that aren't created by a CPU.
+     */
+    static void *
+    allocateHeap(size_t size)
+    {
+        Header *header =
+            static_cast<Header *>(::operator new(sizeof(Header) + size));
+        header->pool = NULL;
+        return header + 1;
+    }
+
+    /** Release storage from allocate() or allocateHeap(). */
+    static void
+    deallocate(void *p)
+    {
+        if (!p)
+            return;
+
+        Header *header = static_cast<Header *>(p) - 1;
+        InstPool *pool = header->pool;
+        if (!pool) {
+            ::operator delete(header);
+            return;
+        }
+
+        header->next = pool->freeList;
+        pool->freeList = header;
+    }
+
+  private:
+    /**
+     * Block header, padded to keep the instruction that follows it
+     * as aligned as the host heap would.
+     */
+    union alignas(16) Header
+    {
+        /** Owning pool, while the block is allocated */
+        InstPool *pool;
+        /** Next free block, while the block is free */
+        Header *next;
+    };
+
+    /** Block size including its header */
+    const size_t stride;
+    const size_t blockSize;
+    const size_t capacity;
+
+    Header *freeList;
+
+    /** Host memory of the pool, capacity blocks per chunk */
+    std::vector<char *> chunks;
+    Counter numBlocks;
+
+    /** Add capacity blocks to the free list. */
+    void grow();
+
+    Stats::Scalar allocs;
+    Stats::Scalar exhausted;
+    Stats::Value blocks;
+};
+
+/**
+ * Base of the classes allocated from an InstPool. Instructions
+ * created with new (pool) come from the pool, the ones created with a
+ * plain new expression from the host heap, and delete returns either
+ * to where it came from.
+ */
+class InstPoolAllocated
+{
+  public:
+    static void *
+    operator new(size_t size, InstPool &pool)
+    {
+        return pool.allocate(size);
+    }
+
+    static void *
+    operator new(size_t size)
+    {
+        return InstPool::allocateHeap(size);
+    }
+
+    static void
+    operator delete(void *p, InstPool &pool)
+    {
+        InstPool::deallocate(p);
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        InstPool::deallocate(p);
+    }
+};
+
+#endif // __CPU_INST_POOL_HH__
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Sequence-number-indexed ring of in-flight instructions.
+ */
+
+#ifndef __CPU_INST_RING_HH__
+#define __CPU_INST_RING_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+
+/**
+ * An ordered container of instructions indexed by their sequence
+ * number.
+ *
+ * The pipeline structures that track instructions in program order
+ * only ever add younger instructions at the tail, retire the oldest
+ * from the head and squash from the tail, while other removals are
+ * rare. The ring keeps each instruction in the slot its sequence
+ * number maps to, so adding, finding and removing an instruction is
+ * a direct index and never allocates once the ring has grown to the
+ * span of sequence numbers in flight. Removed slots are cleared and
+ * skipped by iteration; the head and tail are moved past them so that
+ * both ends always hold an instruction.
+ *
+ * Iterators stay valid until the element they refer to is removed
+ * and, like std::list ones, decrementing the first element's iterator
+ * or incrementing the last one gives end().
+ *
+ * @tparam T Pointer-like element type. A value-initialised T is
+ *           empty and a stored one must convert to true.
+ */
+template <class T>
+class InstRing
+{
+  private:
+    /** Sequence number of end() iterators. */
+    static constexpr InstSeqNum endSeq =
+        std::numeric_limits<InstSeqNum>::max();
+
+  public:
+    class iterator
+      : public std::iterator<std::bidirectional_iterator_tag, T>
+    {
+      private:
+        InstRing *ring;
+        InstSeqNum seq;
+
+        friend class InstRing;
+
+      public:
+        iterator() : ring(nullptr), seq(endSeq) { }
+        iterator(InstRing *_ring, InstSeqNum _seq)
+            : ring(_ring), seq(_seq)
+        { }
+
+        T &operator*() const { return ring->slot(seq); }
+        T *operator->() const { return &ring->slot(seq); }
+
+        bool operator==(const iterator &o) const { return seq == o.seq; }
+        bool operator!=(const iterator &o) const { return seq != o.seq; }
+
+        iterator &
+        operator++()
+        {
+            assert(seq != endSeq);
+            seq = ring->nextLive(seq + 1);
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        iterator &
+        operator--()
+        {
+            seq = ring->prevLive(seq);
+            return *this;
+        }
+
+        iterator
+        operator--(int)
+        {
+            iterator it(*this);
+            --*this;
+            return it;
+        }
+    };
+
+    /** @param capacity Initial number of slots, rounded up to a power
+     *                  of two. The ring doubles when it is too small. */
+    explicit InstRing(size_t capacity = 64)
+        : slots(roundUp(capacity)), mask(slots.size() - 1),
+          headSeq(0), tailSeq(0), numEntries(0)
+    { }
+
+    bool empty() const { return numEntries == 0; }
+    size_t size() const { return numEntries; }
+
+    iterator begin() { return iterator(this, empty() ? endSeq : headSeq); }
+    iterator end() { return iterator(this, endSeq); }
+
+    T &front() { assert(!empty()); return slot(headSeq); }
+    T &back() { assert(!empty()); return slot(tailSeq - 1); }
+
+    /** Iterator to the instruction with the given sequence number, or
+     *  end() if it isn't in the ring. */
+    iterator
+    find(InstSeqNum seq)
+    {
+        if (seq < headSeq || seq >= tailSeq || !slot(seq))
+            return end();
+        return iterator(this, seq);
+    }
+
+    /** Add an instruction younger than all the ones in the ring. */
+    void
+    push_back(InstSeqNum seq, const T &inst)
+    {
+        assert(inst);
+        if (empty()) {
+            headSeq = seq;
+        } else {
+            assert(seq >= tailSeq);
+        }
+        if (seq - headSeq >= slots.size())
+            grow(seq - headSeq + 1);
+
+        slot(seq) = inst;
+        tailSeq = seq + 1;
+        ++numEntries;
+    }
+
+    /** Remove the instruction with the given sequence number. */
+    void
+    erase(InstSeqNum seq)
+    {
+        assert(seq >= headSeq && seq < tailSeq && slot(seq));
+        slot(seq) = T();
+
+        if (--numEntries == 0) {
+            headSeq = tailSeq;
+            return;
+        }
+        while (!slot(headSeq))
+            ++headSeq;
+        while (!slot(tailSeq - 1))
+            --tailSeq;
+    }
+
+    void erase(const iterator &it) { erase(it.seq); }
+    void pop_front() { erase(headSeq); }
+    void pop_back() { erase(tailSeq - 1); }
+
+    void
+    clear()
+    {
+        for (InstSeqNum seq = headSeq; seq < tailSeq; ++seq)
+            slot(seq) = T();
+        headSeq = tailSeq;
+        numEntries = 0;
+    }
+
+  private:
+    std::vector<T> slots;
+    /** slots.size() - 1, the slots are a power of two. */
+    size_t mask;
+    /** Sequence number of the oldest instruction. */
+    InstSeqNum headSeq;
+    /** One past the sequence number of the youngest instruction. */
+    InstSeqNum tailSeq;
+    size_t numEntries;
+
+    static size_t
+    roundUp(size_t n)
+    {
+        size_t size = 1;
+        while (size < n)
+            size <<= 1;
+        return size;
+    }
+
+    T &slot(InstSeqNum seq) { return slots[seq & mask]; }
+
+    /** Re-index the instructions into a ring spanning span numbers. */
+    void
+    grow(size_t span)
+    {
+        std::vector<T> bigger(roundUp(span));
+        size_t bigger_mask = bigger.size() - 1;
+        for (InstSeqNum seq = headSeq; seq < tailSeq; ++seq)
+            std::swap(bigger[seq & bigger_mask], slot(seq));
+        slots.swap(bigger);
+        mask = bigger_mask;
+    }
+
+    /** First instruction at or after seq. */
+    InstSeqNum
+    nextLive(InstSeqNum seq)
+    {
+        while (seq < tailSeq && !slot(seq))
+            ++seq;
+        return seq < tailSeq ? seq : endSeq;
+    }
+
+    /** Last instruction before seq, end() before the head. */
+    InstSeqNum
+    prevLive(InstSeqNum seq)
+    {
+        if (seq == endSeq)
+            return empty() ? endSeq : tailSeq - 1;
+        do {
+            if (seq <= headSeq)
+                return endSeq;
+        } while (!slot(--seq));
+        return seq;
+    }
+};
+
+template <class T>
+constexpr InstSeqNum InstRing<T>::endSeq;
+
+#endif // __CPU_INST_RING_HH__
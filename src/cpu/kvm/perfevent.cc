@@ -160,6 +160,14 @@ PerfKvmCounter::enableSignals(pid_t tid, int signal)
 void
 PerfKvmCounter::attach(PerfKvmCounterConfig &config,
                     pid_t tid, int group_fd)
+{
+    if (!tryAttach(config, tid, group_fd))
+        panic("PerfKvmCounter::open failed (%i)\n", errno);
+}
+
+bool
+PerfKvmCounter::tryAttach(PerfKvmCounterConfig &config,
+                          pid_t tid, int group_fd)
 {
     assert(!attached());
 
@@ -169,9 +177,10 @@ PerfKvmCounter::attach(PerfKvmCounterConfig &config,
                  group_fd,
                  0); // Flags
     if (fd == -1)
-        panic("PerfKvmCounter::open failed (%i)\n", errno);
+        return false;
 
     mmapPerf(1);
+    return true;
 }
 
 pid_t
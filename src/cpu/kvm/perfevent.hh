@@ -160,6 +160,17 @@ class PerfKvmCounterConfig
         return *this;
     }
 
+    /**
+     * Exclude events in the kernel (i.e., only count user
+     * space). Unprivileged users can usually only count user space.
+     *
+     * @param val true to exclude kernel events
+     */
+    PerfKvmCounterConfig &exclude_kernel(bool val) {
+        attr.exclude_kernel = val;
+        return *this;
+    }
+
     /** Underlying perf_event_attr structure describing the counter */
     struct perf_event_attr attr;
 };
@@ -223,6 +234,22 @@ public:
         attach(config, tid, parent.fd);
     }
 
+    /**
+     * Attach a counter like attach(), but return false rather than
+     * panic if the host refuses to open it (e.g., because of
+     * perf_event_paranoid or a lack of hardware counters). errno is
+     * left as set by perf_event_open.
+     *
+     * @param config Counter configuration
+     * @param tid Thread to sample (0 indicates current thread)
+     * @param parent Group leader, or NULL to attach a new group
+     * @return true if the counter was attached
+     */
+    bool tryAttach(PerfKvmCounterConfig &config, pid_t tid,
+                   const PerfKvmCounter *parent = NULL) {
+        return tryAttach(config, tid, parent ? parent->fd : -1);
+    }
+
     /** Detach a counter from PerfEvent. */
     void detach();
 
@@ -306,6 +333,7 @@ private:
     PerfKvmCounter &operator=(const PerfKvmCounter &that);
 
     void attach(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
+    bool tryAttach(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
 
     /**
      * Get the TID of the current thread.
@@ -49,6 +49,14 @@
 
 MinorCPU::MinorCPU(MinorCPUParams *params) :
     BaseCPU(params),
+    /* Enough for full inter-stage buffers and memory accesses, the pool
+     *  grows if that's not enough */
+    instPool(sizeof(Minor::MinorDynInst),
+        (params->decodeInputBufferSize * params->decodeInputWidth +
+        params->executeInputBufferSize * params->executeInputWidth +
+        params->executeLSQRequestsQueueSize +
+        params->executeLSQTransfersQueueSize +
+        params->executeLSQStoreBufferSize) * params->numThreads),
     threadPolicy(params->threadPolicy)
 {
     /* This is only written for one thread at the moment */
@@ -127,6 +135,7 @@ MinorCPU::regStats()
 {
     BaseCPU::regStats();
     stats.regStats(name(), *this);
+    instPool.regStats(name() + ".instPool");
     pipeline->regStats();
 }
 
@@ -49,6 +49,7 @@
 #include "cpu/minor/activity.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/base.hh"
+#include "cpu/inst_pool.hh"
 #include "cpu/simple_thread.hh"
 #include "enums/ThreadPolicy.hh"
 #include "params/MinorCPU.hh"
@@ -94,6 +95,11 @@ class MinorCPU : public BaseCPU
      *  threads[threadId]->getTC() */
     std::vector<Minor::MinorThread *> threads;
 
+    /** Storage of the MinorDynInsts made by Fetch2 and Decode.  The
+     *  pipeline is deleted in ~MinorCPU so this outlives its
+     *  instructions */
+    InstPool instPool;
+
   public:
     /** Provide a non-protected base class for Minor's Ports as derived
      *  classes are created by Fetch1 and Execute */
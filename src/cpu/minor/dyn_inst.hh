@@ -52,6 +52,7 @@
 
 #include "base/refcnt.hh"
 #include "cpu/minor/buffers.hh"
+#include "cpu/inst_pool.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/static_inst.hh"
 #include "cpu/timing_expr.hh"
@@ -153,8 +154,10 @@ std::ostream &operator <<(std::ostream &os, const MinorDynInst &inst);
 /** Dynamic instruction for Minor.
  *  MinorDynInst implements the BubbleIF interface
  *  Has two separate notions of sequence number for pre/post-micro-op
- *  decomposition: fetchSeqNum and execSeqNum */
-class MinorDynInst : public RefCounted
+ *  decomposition: fetchSeqNum and execSeqNum
+ *  Instructions made by the pipeline come from MinorCPU::instPool,
+ *  the bubble from the host heap */
+class MinorDynInst : public RefCounted, public InstPoolAllocated
 {
   private:
     /** A prototypical bubble instruction.  You must call MinorDynInst::init
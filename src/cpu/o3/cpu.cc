@@ -141,6 +141,12 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
     : BaseO3CPU(params),
       itb(params->itb),
       dtb(params->dtb),
+      // Enough for the instructions in the back end and a full fetch
+      // queue per thread, the pool grows if that's not enough.
+      instPool(sizeof(typename Impl::DynInst),
+               params->numROBEntries + params->numIQEntries +
+               params->LQEntries + params->SQEntries +
+               params->fetchQueueSize * params->numThreads),
       tickEvent([this]{ tick(); }, "FullO3CPU tick",
                 false, Event::CPU_Tick_Pri),
 #ifndef NDEBUG
@@ -442,6 +448,8 @@ FullO3CPU<Impl>::regStats()
 {
     BaseO3CPU::regStats();
 
+    instPool.regStats(name() + ".instPool");
+
     // Register any of the O3CPU's stats here.
     timesIdled
         .name(name() + ".timesIdled")
@@ -1555,12 +1563,10 @@ FullO3CPU<Impl>::squashFromTC(ThreadID tid)
 }
 
 template <class Impl>
-typename FullO3CPU<Impl>::ListIt
+void
 FullO3CPU<Impl>::addInst(DynInstPtr &inst)
 {
-    instList.push_back(inst);
-
-    return --(instList.end());
+    instList.push_back(inst->seqNum, inst);
 }
 
 template <class Impl>
@@ -1596,7 +1602,7 @@ FullO3CPU<Impl>::removeFrontInst(DynInstPtr &inst)
     removeInstsThisCycle = true;
 
     // Remove the front instruction.
-    removeList.push(inst->getInstListIt());
+    removeList.push_back(instList.find(inst->seqNum));
 }
 
 template <class Impl>
@@ -1617,7 +1623,7 @@ FullO3CPU<Impl>::removeInstsNotInROB(ThreadID tid)
         end_it = instList.begin();
         rob_empty = true;
     } else {
-        end_it = (rob.readTailInst(tid))->getInstListIt();
+        end_it = instList.find(rob.readTailInst(tid)->seqNum);
         DPRINTF(O3CPU, "ROB is not empty, squashing insts not in ROB.\n");
     }
 
@@ -1690,7 +1696,7 @@ FullO3CPU<Impl>::squashInstIt(const ListIt &instIt, ThreadID tid)
         // @todo: Formulate a consistent method for deleting
         // instructions from the instruction list
         // Remove the instruction from the list.
-        removeList.push(instIt);
+        removeList.push_back(instIt);
     }
 }
 
@@ -1698,17 +1704,16 @@ template <class Impl>
 void
 FullO3CPU<Impl>::cleanUpRemovedInsts()
 {
-    while (!removeList.empty()) {
+    for (auto &inst_it : removeList) {
         DPRINTF(O3CPU, "Removing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*removeList.front())->threadNumber,
-                (*removeList.front())->seqNum,
-                (*removeList.front())->pcState());
-
-        instList.erase(removeList.front());
+                (*inst_it)->threadNumber,
+                (*inst_it)->seqNum,
+                (*inst_it)->pcState());
 
-        removeList.pop();
+        instList.erase(inst_it);
     }
+    removeList.clear();
 
     removeInstsThisCycle = false;
 }
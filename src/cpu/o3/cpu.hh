@@ -63,6 +63,8 @@
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
+#include "cpu/inst_pool.hh"
+#include "cpu/inst_ring.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
 //#include "cpu/o3/thread_context.hh"
@@ -110,7 +112,7 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename InstRing<DynInstPtr>::iterator ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -129,6 +131,12 @@ class FullO3CPU : public BaseO3CPU
     /** Overall CPU status. */
     Status _status;
 
+    /**
+     * Storage of the dynamic instructions. Declared before anything
+     * that may hold on to an instruction so that it's destroyed last.
+     */
+    InstPool instPool;
+
   private:
 
     /**
@@ -537,7 +545,7 @@ class FullO3CPU : public BaseO3CPU
     /** Function to add instruction onto the head of the list of the
      *  instructions.  Used when new instructions are fetched.
      */
-    ListIt addInst(DynInstPtr &inst);
+    void addInst(DynInstPtr &inst);
 
     /** Function to tell the CPU that an instruction has completed. */
     void instDone(ThreadID tid, DynInstPtr &inst);
@@ -570,12 +578,12 @@ class FullO3CPU : public BaseO3CPU
 #endif
 
     /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    InstRing<DynInstPtr> instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
      */
-    std::queue<ListIt> removeList;
+    std::vector<ListIt> removeList;
 
 #ifdef DEBUG
     /** Debug structure to keep track of the sequence numbers still in
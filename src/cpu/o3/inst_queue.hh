@@ -44,6 +44,7 @@
 #ifndef __CPU_O3_INST_QUEUE_HH__
 #define __CPU_O3_INST_QUEUE_HH__
 
+#include <deque>
 #include <list>
 #include <map>
 #include <queue>
@@ -52,6 +53,8 @@
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/ready_slots.hh"
+#include "cpu/inst_ring.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -62,9 +65,10 @@ class FUPool;
 class MemInterface;
 
 /**
- * A standard instruction queue class.  It holds ready instructions, in
- * order, in seperate priority queues to facilitate the scheduling of
- * instructions.  The IQ uses a separate linked list to track dependencies.
+ * A standard instruction queue class.  Each instruction in it holds a
+ * slot, and the slots of ready instructions are kept in bitmaps, by op
+ * class, to facilitate the scheduling of instructions.  The IQ uses a
+ * separate linked list to track dependencies.
  * Similar to the rename map and the free list, it expects that
  * floating point registers have their indices start after the integer
  * registers (ie with 96 int and 96 fp registers, regs 0-95 are integer
@@ -92,10 +96,13 @@ class InstructionQueue
     typedef typename Impl::CPUPol::TimeStruct TimeStruct;
 
     // Typedef of iterator through the list of instructions.
+    typedef typename InstRing<DynInstPtr>::iterator InstListIt;
+
+    // Typedef of iterator through the lists of memory instructions.
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
     /** FU completion event class. */
-    class FUCompletion : public Event {
+    class FUCompletion : public PooledEvent {
       private:
         /** Executing instruction. */
         DynInstPtr inst;
@@ -312,10 +319,10 @@ class InstructionQueue
     //////////////////////////////////////
 
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstRing<DynInstPtr> instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    std::deque<DynInstPtr> instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -330,27 +337,13 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
-     */
-    struct pqCompare {
-        bool operator() (const DynInstPtr &lhs, const DynInstPtr &rhs) const
-        {
-            return lhs->seqNum > rhs->seqNum;
-        }
-    };
-
-    typedef std::priority_queue<DynInstPtr, std::vector<DynInstPtr>, pqCompare>
-    ReadyInstQueue;
+    /** The instructions in the IQ, indexed by their slot. */
+    std::vector<DynInstPtr> slotInsts;
 
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
+    /** Ready instructions, by slot and op class.  Used to select the
+     *  oldest ready instruction among op classes.
      */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    ReadySlots readySlots;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -363,39 +356,11 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
+    /** Give an instruction entering the IQ a slot. */
+    void allocateSlot(DynInstPtr &inst);
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
-
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
-
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
-
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
-
-    /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
-     */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    /** Free the slot of an instruction leaving the IQ. */
+    void releaseSlot(DynInstPtr &inst);
 
     DependencyGraph<DynInstPtr> dependGraph;
 
@@ -62,7 +62,7 @@ using std::list;
 template <class Impl>
 InstructionQueue<Impl>::FUCompletion::FUCompletion(DynInstPtr &_inst,
     int fu_idx, InstructionQueue<Impl> *iq_ptr)
-    : Event(Stat_Event_Pri, AutoDelete),
+    : PooledEvent(Stat_Event_Pri, AutoDelete),
       inst(_inst), fuIdx(fu_idx), iqPtr(iq_ptr), freeFU(false)
 {
 }
@@ -89,6 +89,7 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params->fuPool),
+      readySlots(params->numIQEntries),
       numEntries(params->numIQEntries),
       totalWidth(params->issueWidth),
       commitToIEWDelay(params->commitToIEWDelay)
@@ -117,6 +118,8 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
         memDepUnit[tid].setIQ(this);
     }
 
+    slotInsts.resize(numEntries);
+
     resetState();
 
     std::string policy = params->smtIQPolicy;
@@ -407,14 +410,11 @@ InstructionQueue<Impl>::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
+    for (int i = 0; i < numEntries; ++i) {
+        slotInsts[i] = NULL;
     }
+    readySlots.clear();
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -550,17 +550,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return readySlots.anyReady();
 }
 
 template <class Impl>
@@ -582,11 +572,12 @@ InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    instList[new_inst->threadNumber].push_back(new_inst->seqNum, new_inst);
 
     --freeEntries;
 
     new_inst->setInIQ();
+    allocateSlot(new_inst);
 
     // Look through its source registers (physical regs), and mark any
     // dependencies.
@@ -633,11 +624,12 @@ InstructionQueue<Impl>::insertNonSpec(DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    instList[new_inst->threadNumber].push_back(new_inst->seqNum, new_inst);
 
     --freeEntries;
 
     new_inst->setInIQ();
+    allocateSlot(new_inst);
 
     // Have this instruction set itself as the producer of its destination
     // register(s).
@@ -684,55 +676,23 @@ InstructionQueue<Impl>::getInstToExecute()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+InstructionQueue<Impl>::allocateSlot(DynInstPtr &inst)
 {
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
-    }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
+    assert(inst->iqSlot < 0);
+    inst->iqSlot = readySlots.allocate(inst->seqNum, inst->opClass());
+    slotInsts[inst->iqSlot] = inst;
 }
 
 template <class Impl>
 void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+InstructionQueue<Impl>::releaseSlot(DynInstPtr &inst)
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
+    if (inst->iqSlot < 0)
+        return;
 
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    readySlots.release(inst->iqSlot);
+    slotInsts[inst->iqSlot] = NULL;
+    inst->iqSlot = -1;
 }
 
 template <class Impl>
@@ -778,24 +738,21 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
+    // Take the ready instructions oldest first.
+    // While I haven't exceeded bandwidth or run out of ready instructions,
     // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
+    // If there is none, drop the rest of the op class from this round.
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    int slot;
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    readySlots.startSelect();
 
-        assert(!readyInsts[op_class].empty());
-
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+    while (total_issued < totalWidth &&
+           (slot = readySlots.selectOldest()) >= 0) {
+        DynInstPtr issuing_inst = slotInsts[slot];
+        OpClass op_class = issuing_inst->opClass();
 
         if (issuing_inst->isFloating()) {
             fpInstQueueReads++;
@@ -805,19 +762,10 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
+        assert(issuing_inst->seqNum == readySlots.seqNum(slot));
 
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            readySlots.clearReady(slot);
 
             ++iqSquashedInstsIssued;
 
@@ -878,14 +826,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            readySlots.clearReady(slot);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -900,16 +841,16 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 ++freeEntries;
                 count[tid]--;
                 issuing_inst->clearInIQ();
+                releaseSlot(issuing_inst);
             } else {
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            readySlots.skipOpClass(op_class);
         }
     }
 
@@ -962,7 +903,7 @@ InstructionQueue<Impl>::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i]: Committing instructions older than [sn:%i]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
+    InstListIt iq_it = instList[tid].begin();
 
     while (iq_it != instList[tid].end() &&
            (*iq_it)->seqNum <= inst) {
@@ -1061,23 +1002,19 @@ template <class Impl>
 void
 InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
 {
-    OpClass op_class = ready_inst->opClass();
-
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
+    // Instructions squashed while waiting for a translation or the
+    // cache have already left the IQ.
+    if (ready_inst->iqSlot < 0) {
+        assert(ready_inst->isSquashed());
+        ++iqSquashedInstsIssued;
+        return;
     }
 
+    readySlots.setReady(ready_inst->iqSlot);
+
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%lli].\n",
-            ready_inst->pcState(), op_class, ready_inst->seqNum);
+            ready_inst->pcState(), ready_inst->opClass(), ready_inst->seqNum);
 }
 
 template <class Impl>
@@ -1113,6 +1050,7 @@ InstructionQueue<Impl>::completeMemInst(DynInstPtr &completed_inst)
     ++freeEntries;
 
     completed_inst->memOpDone(true);
+    releaseSlot(completed_inst);
 
     memDepUnit[tid].completed(completed_inst);
     count[tid]--;
@@ -1205,7 +1143,7 @@ void
 InstructionQueue<Impl>::doSquash(ThreadID tid)
 {
     // Start at the tail.
-    ListIt squash_it = instList[tid].end();
+    InstListIt squash_it = instList[tid].end();
     --squash_it;
 
     DPRINTF(IQ, "[tid:%i]: Squashing until sequence number %i!\n",
@@ -1316,6 +1254,15 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             count[squashed_inst->threadNumber]--;
 
             ++freeEntries;
+
+            // Ready instructions would have been popped and counted
+            // as squashed issues at issue time, count them here as
+            // their slot goes away.
+            if (squashed_inst->iqSlot >= 0 &&
+                readySlots.isReady(squashed_inst->iqSlot)) {
+                ++iqSquashedInstsIssued;
+            }
+            releaseSlot(squashed_inst);
         }
 
         instList[tid].erase(squash_it--);
@@ -1427,23 +1374,11 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
             return;
         }
 
-        OpClass op_class = inst->opClass();
-
         DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
                 "the ready list, PC %s opclass:%i [sn:%lli].\n",
-                inst->pcState(), op_class, inst->seqNum);
-
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+                inst->pcState(), inst->opClass(), inst->seqNum);
+
+        readySlots.setReady(inst->iqSlot);
     }
 }
 
@@ -1459,7 +1394,7 @@ InstructionQueue<Impl>::countInsts()
     int total_insts = 0;
 
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
-        ListIt count_it = instList[tid].begin();
+        InstListIt count_it = instList[tid].begin();
 
         while (count_it != instList[tid].end()) {
             if (!(*count_it)->isSquashed() && !(*count_it)->isSquashedInIQ()) {
@@ -1487,11 +1422,7 @@ template <class Impl>
 void
 InstructionQueue<Impl>::dumpLists()
 {
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
-
-        cprintf("\n");
-    }
+    cprintf("Ready list size: %i\n", readySlots.numReady());
 
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
 
@@ -1508,18 +1439,13 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
+    cprintf("Ready list: ");
 
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%lli] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
+    for (int i = 0; i < numEntries; ++i) {
+        if (readySlots.isReady(i)) {
+            cprintf("%i OpClass:%i [sn:%lli] ", i, slotInsts[i]->opClass(),
+                    slotInsts[i]->seqNum);
+        }
     }
 
     cprintf("\n");
@@ -1533,7 +1459,7 @@ InstructionQueue<Impl>::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        InstListIt inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
@@ -1573,7 +1499,7 @@ InstructionQueue<Impl>::dumpInsts()
 
     int num = 0;
     int valid_num = 0;
-    ListIt inst_list_it = instsToExecute.begin();
+    auto inst_list_it = instsToExecute.begin();
 
     while (inst_list_it != instsToExecute.end())
     {
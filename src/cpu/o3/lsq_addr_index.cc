@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/lsq_addr_index.hh"
+
+#include <cassert>
+
+LSQAddrIndex::LSQAddrIndex()
+    : granuleShift(0), maxSpan(1), bucketBits(0)
+{
+}
+
+void
+LSQAddrIndex::init(unsigned num_entries, unsigned granule_shift)
+{
+    granuleShift = granule_shift;
+    entries.assign(num_entries, Entry());
+    clear();
+}
+
+void
+LSQAddrIndex::resize(unsigned num_entries)
+{
+    entries.resize(num_entries);
+    rehash();
+}
+
+void
+LSQAddrIndex::insert(int idx, Addr addr, unsigned size)
+{
+    assert(size > 0);
+    remove(idx);
+
+    Entry &entry = entries[idx];
+    entry.first = addr >> granuleShift;
+    entry.last = (addr + size - 1) >> granuleShift;
+    if (entry.last - entry.first + 1 > maxSpan)
+        maxSpan = entry.last - entry.first + 1;
+
+    int &head = heads[bucket(entry.first)];
+    entry.prev = -1;
+    entry.next = head;
+    if (head != -1)
+        entries[head].prev = idx;
+    head = idx;
+    entry.indexed = true;
+}
+
+void
+LSQAddrIndex::remove(int idx)
+{
+    Entry &entry = entries[idx];
+    if (!entry.indexed)
+        return;
+
+    if (entry.prev != -1)
+        entries[entry.prev].next = entry.next;
+    else
+        heads[bucket(entry.first)] = entry.next;
+    if (entry.next != -1)
+        entries[entry.next].prev = entry.prev;
+
+    entry.next = entry.prev = -1;
+    entry.indexed = false;
+}
+
+void
+LSQAddrIndex::clear()
+{
+    for (auto &entry : entries)
+        entry = Entry();
+    maxSpan = 1;
+    rehash();
+}
+
+void
+LSQAddrIndex::rehash()
+{
+    // Twice as many buckets as entries keeps the chains short.
+    bucketBits = 4;
+    while ((1U << bucketBits) < 2 * entries.size())
+        ++bucketBits;
+    heads.assign(1U << bucketBits, -1);
+
+    for (int idx = 0; idx < entries.size(); ++idx) {
+        Entry &entry = entries[idx];
+        if (!entry.indexed)
+            continue;
+        int &head = heads[bucket(entry.first)];
+        entry.prev = -1;
+        entry.next = head;
+        if (head != -1)
+            entries[head].prev = idx;
+        head = idx;
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_LSQ_ADDR_INDEX_HH__
+#define __CPU_O3_LSQ_ADDR_INDEX_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Address hash over the entries of a load or store queue.
+ *
+ * The address range of a queue entry is cut into granules of
+ * 2^granule_shift bytes, and the entry is chained into the hash bucket
+ * of its first granule.  Finding the entries that may overlap an access
+ * then only walks the buckets of the granules the access touches (plus
+ * the few before it that an entry spanning several granules could start
+ * in) instead of the whole queue.  The chains live in per-entry arrays
+ * sized with the queue, so keeping the index up to date never
+ * allocates.
+ *
+ * The index only answers which entries overlap at granule level; the
+ * caller still filters them by queue position and applies its exact
+ * overlap test.
+ */
+class LSQAddrIndex
+{
+  public:
+    LSQAddrIndex();
+
+    /**
+     * @param num_entries Number of queue entries.
+     * @param granule_shift log2 of the granule size in bytes.
+     */
+    void init(unsigned num_entries, unsigned granule_shift);
+
+    /** Follow a change in the number of queue entries. */
+    void resize(unsigned num_entries);
+
+    /**
+     * Index the entry at a queue index as accessing [addr, addr + size).
+     * An entry that is already indexed is moved.
+     */
+    void insert(int idx, Addr addr, unsigned size);
+
+    /** Drop the entry at a queue index, if it is indexed. */
+    void remove(int idx);
+
+    bool contains(int idx) const { return entries[idx].indexed; }
+
+    /** Drop all the entries. */
+    void clear();
+
+    /**
+     * Call f(idx) once for every indexed entry that shares a granule
+     * with [addr, addr + size).
+     */
+    template <class F>
+    void
+    forEachOverlap(Addr addr, unsigned size, F f) const
+    {
+        const Addr first = addr >> granuleShift;
+        const Addr last = (addr + size - 1) >> granuleShift;
+        const Addr from = first >= maxSpan - 1 ? first - (maxSpan - 1) : 0;
+
+        if (last - from >= heads.size()) {
+            // Walking every bucket visits each entry once anyway.
+            for (int head : heads) {
+                for (int idx = head; idx != -1; idx = entries[idx].next) {
+                    if (entries[idx].last >= first &&
+                        entries[idx].first <= last)
+                        f(idx);
+                }
+            }
+            return;
+        }
+
+        // Several granules may share a bucket, so an entry is only
+        // reported from the bucket walk of its own first granule.
+        for (Addr granule = from; granule <= last; ++granule) {
+            for (int idx = heads[bucket(granule)]; idx != -1;
+                 idx = entries[idx].next) {
+                if (entries[idx].first == granule &&
+                    entries[idx].last >= first)
+                    f(idx);
+            }
+        }
+    }
+
+  private:
+    struct Entry
+    {
+        /** First and last granule of the access. */
+        Addr first;
+        Addr last;
+        /** Neighbours in the bucket chain, -1 at either end. */
+        int next;
+        int prev;
+        bool indexed;
+
+        Entry() : first(0), last(0), next(-1), prev(-1), indexed(false) {}
+    };
+
+    unsigned granuleShift;
+
+    /** Granules covered by the widest entry indexed since the last clear. */
+    Addr maxSpan;
+
+    /** log2 of the number of buckets. */
+    unsigned bucketBits;
+
+    /** First entry of each bucket chain, -1 if empty. */
+    std::vector<int> heads;
+
+    /** Chain links and granule range of each queue entry. */
+    std::vector<Entry> entries;
+
+    unsigned
+    bucket(Addr granule) const
+    {
+        return (granule * 0x9e3779b97f4a7c15ULL) >> (64 - bucketBits);
+    }
+
+    /** Size the buckets for the queue and rebuild the chains. */
+    void rehash();
+};
+
+#endif // __CPU_O3_LSQ_ADDR_INDEX_HH__
@@ -56,6 +56,7 @@
 #include "arch/mmapped_ipr.hh"
 #include "config/the_isa.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/o3/lsq_addr_index.hh"
 #include "cpu/timebuf.hh"
 #include "debug/LSQUnit.hh"
 #include "mem/packet.hh"
@@ -310,7 +311,7 @@ class LSQUnit {
     };
 
     /** Writeback event, specifically for when stores forward data to loads. */
-    class WritebackEvent : public Event {
+    class WritebackEvent : public PooledEvent {
       public:
         /** Constructs a writeback event. */
         WritebackEvent(DynInstPtr &_inst, PacketPtr pkt, LSQUnit *lsq_ptr);
@@ -404,6 +405,15 @@ class LSQUnit {
      */
     unsigned depCheckShift;
 
+    /** Address index over the loads that have issued their access. */
+    LSQAddrIndex loadIndex;
+
+    /** Address index over the stores that have their data. */
+    LSQAddrIndex storeIndex;
+
+    /** Scratch list of load ages for checkViolations(). */
+    std::vector<int> violationCandidates;
+
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
@@ -558,6 +568,10 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
 
     assert(!load_inst->isExecuted());
 
+    // The effective address has just been set; later stores check it for
+    // ordering violations through the index.
+    loadIndex.insert(load_idx, load_inst->effAddr, load_inst->effSize);
+
     // Make sure this isn't a strictly ordered load
     // A bit of a hackish way to get strictly ordered accesses to work
     // only if they're at the head of the LSQ and are ready to commit
@@ -636,25 +650,36 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
         return NoFault;
     }
 
-    while (store_idx != -1) {
-        // End once we've reached the top of the LSQ
-        if (store_idx == storeWBIdx) {
-            break;
-        }
-
-        // Move the index to one younger
-        if (--store_idx < 0)
-            store_idx += SQEntries;
-
-        assert(storeQueue[store_idx].inst);
+    // Only the youngest store that is older than the load, hasn't been
+    // written back and overlaps it decides.  Walk the stores the index
+    // has near the load's address rather than the whole SQ.
+    int forward_idx = -1;
+    if (store_idx != -1 && store_idx != storeWBIdx) {
+        const int range = (store_idx - storeWBIdx + SQEntries) % SQEntries;
+        int youngest_age = -1;
+        storeIndex.forEachOverlap(req->getVaddr(), req->getSize(),
+                                  [&](int idx) {
+            const int age = (idx - storeWBIdx + SQEntries) % SQEntries;
+            if (age >= range || age <= youngest_age)
+                return;
+
+            const SQEntry &store = storeQueue[idx];
+            assert(store.inst);
+            if (store.size == 0 || store.inst->strictlyOrdered())
+                return;
+
+            if (req->getVaddr() < store.inst->effAddr + store.size &&
+                req->getVaddr() + req->getSize() > store.inst->effAddr) {
+                forward_idx = idx;
+                youngest_age = age;
+            }
+        });
+    }
 
+    if (forward_idx != -1) {
+        store_idx = forward_idx;
         store_size = storeQueue[store_idx].size;
 
-        if (store_size == 0)
-            continue;
-        else if (storeQueue[store_idx].inst->strictlyOrdered())
-            continue;
-
         assert(storeQueue[store_idx].inst->effAddrValid());
 
         // Check if the store data is within the lower and upper bounds of
@@ -664,12 +689,6 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
         bool store_has_upper_limit =
             (req->getVaddr() + req->getSize()) <=
             (storeQueue[store_idx].inst->effAddr + store_size);
-        bool lower_load_has_store_part =
-            req->getVaddr() < (storeQueue[store_idx].inst->effAddr +
-                           store_size);
-        bool upper_load_has_store_part =
-            (req->getVaddr() + req->getSize()) >
-            storeQueue[store_idx].inst->effAddr;
 
         // If the store's data has all of the data needed and the load isn't
         // LLSC, we can forward.
@@ -708,25 +727,15 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
 
             ++lsqForwLoads;
             return NoFault;
-        } else if (
-                (!req->isLLSC() &&
-                 ((store_has_lower_limit && lower_load_has_store_part) ||
-                  (store_has_upper_limit && upper_load_has_store_part) ||
-                  (lower_load_has_store_part && upper_load_has_store_part))) ||
-                (req->isLLSC() &&
-                 ((store_has_lower_limit || upper_load_has_store_part) &&
-                  (store_has_upper_limit || lower_load_has_store_part)))) {
+        } else {
             // This is the partial store-load forwarding case where a store
             // has only part of the load's data and the load isn't LLSC or
             // the load is LLSC and the store has all or part of the load's
             // data
 
-            // If it's already been written back, then don't worry about
-            // stalling on it.
-            if (storeQueue[store_idx].completed) {
+            // Stores that have been written back aren't searched.
+            if (storeQueue[store_idx].completed)
                 panic("Should not check one of these");
-                continue;
-            }
 
             // Must stall load and force it to retry, so long as it's the oldest
             // load that needs to do so.
@@ -907,6 +916,9 @@ LSQUnit<Impl>::write(Request *req, Request *sreqLow, Request *sreqHigh,
     if (!(req->getFlags() & Request::CACHE_BLOCK_ZERO))
         memcpy(storeQueue[store_idx].data, data, size);
 
+    // Younger loads can now find the store by its address.
+    storeIndex.insert(store_idx, storeQueue[store_idx].inst->effAddr, size);
+
     // This function only writes the data to the store queue, so no fault
     // can happen here.
     return NoFault;
@@ -63,7 +63,7 @@
 template<class Impl>
 LSQUnit<Impl>::WritebackEvent::WritebackEvent(DynInstPtr &_inst, PacketPtr _pkt,
                                               LSQUnit *lsq_ptr)
-    : Event(Default_Pri, AutoDelete),
+    : PooledEvent(Default_Pri, AutoDelete),
       inst(_inst), pkt(_pkt), lsqPtr(lsq_ptr)
 {
 }
@@ -179,6 +179,11 @@ LSQUnit<Impl>::init(O3CPU *cpu_ptr, IEW *iew_ptr, DerivO3CPUParams *params,
     cacheStorePorts = params->cacheStorePorts;
     needsTSO = params->needsTSO;
 
+    // Loads are hashed at least as coarsely as the violation check
+    // compares them, so any load it flags shares a granule with the store.
+    loadIndex.init(LQEntries, std::max(depCheckShift, 6U));
+    storeIndex.init(SQEntries, 6);
+
     resetState();
 }
 
@@ -193,6 +198,9 @@ LSQUnit<Impl>::resetState()
 
     storeHead = storeWBIdx = storeTail = 0;
 
+    loadIndex.clear();
+    storeIndex.clear();
+
     usedStorePorts = 0;
 
     retryPkt = NULL;
@@ -271,6 +279,7 @@ void
 LSQUnit<Impl>::clearLQ()
 {
     loadQueue.clear();
+    loadIndex.clear();
 }
 
 template<class Impl>
@@ -278,6 +287,7 @@ void
 LSQUnit<Impl>::clearSQ()
 {
     storeQueue.clear();
+    storeIndex.clear();
 }
 
 template<class Impl>
@@ -311,6 +321,7 @@ LSQUnit<Impl>::resizeLQ(unsigned size)
             loadQueue.push_back(dummy);
             LQEntries++;
         }
+        loadIndex.resize(loadQueue.size());
     } else {
         LQEntries = size_plus_sentinel;
     }
@@ -329,6 +340,7 @@ LSQUnit<Impl>::resizeSQ(unsigned size)
             storeQueue.push_back(dummy);
             SQEntries++;
         }
+        storeIndex.resize(storeQueue.size());
     } else {
         SQEntries = size_plus_sentinel;
     }
@@ -372,6 +384,7 @@ LSQUnit<Impl>::insertLoad(DynInstPtr &load_inst)
     }
 
     loadQueue[loadTail] = load_inst;
+    loadIndex.remove(loadTail);
 
     incrLdIdx(loadTail);
 
@@ -393,6 +406,7 @@ LSQUnit<Impl>::insertStore(DynInstPtr &store_inst)
     store_inst->lqIdx = loadTail;
 
     storeQueue[storeTail] = SQEntry(store_inst);
+    storeIndex.remove(storeTail);
 
     incrStIdx(storeTail);
 
@@ -534,12 +548,21 @@ LSQUnit<Impl>::checkViolations(int load_idx, DynInstPtr &inst)
      * all instructions that will execute before the store writes back. Thus,
      * like the implementation that came before it, we're overly conservative.
      */
-    while (load_idx != loadTail) {
-        DynInstPtr ld_inst = loadQueue[load_idx];
-        if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
-            incrLdIdx(load_idx);
+    // Only loads the index has near the address can overlap; check them
+    // oldest first as a walk from load_idx to the tail would.
+    const int range = (loadTail - load_idx + LQEntries) % LQEntries;
+    violationCandidates.clear();
+    loadIndex.forEachOverlap(inst->effAddr, inst->effSize, [&](int idx) {
+        const int age = (idx - load_idx + LQEntries) % LQEntries;
+        if (age < range)
+            violationCandidates.push_back(age);
+    });
+    std::sort(violationCandidates.begin(), violationCandidates.end());
+
+    for (int age : violationCandidates) {
+        DynInstPtr ld_inst = loadQueue[(load_idx + age) % LQEntries];
+        if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered())
             continue;
-        }
 
         Addr ld_eff_addr1 = ld_inst->effAddr >> depCheckShift;
         Addr ld_eff_addr2 =
@@ -593,8 +616,6 @@ LSQUnit<Impl>::checkViolations(int load_idx, DynInstPtr &inst)
                     inst->seqNum, ld_inst->seqNum, ld_eff_addr1);
             }
         }
-
-        incrLdIdx(load_idx);
     }
     return NoFault;
 }
@@ -714,6 +735,7 @@ LSQUnit<Impl>::commitLoad()
             loadQueue[loadHead]->pcState());
 
     loadQueue[loadHead] = NULL;
+    loadIndex.remove(loadHead);
 
     incrLdIdx(loadHead);
 
@@ -1019,6 +1041,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         // Clear the smart pointer to make sure it is decremented.
         loadQueue[load_idx]->setSquashed();
         loadQueue[load_idx] = NULL;
+        loadIndex.remove(load_idx);
         --loads;
 
         // Inefficient!
@@ -1060,6 +1083,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         storeQueue[store_idx].inst->setSquashed();
         storeQueue[store_idx].inst = NULL;
         storeQueue[store_idx].canWB = 0;
+        storeIndex.remove(store_idx);
 
         // Must delete request now that it wasn't handed off to
         // memory.  This is quite ugly.  @todo: Figure out the proper
@@ -1163,6 +1187,7 @@ LSQUnit<Impl>::completeStore(int store_idx)
 {
     assert(storeQueue[store_idx].inst);
     storeQueue[store_idx].completed = true;
+    storeIndex.remove(store_idx);
     --storesToWB;
     // A bit conservative because a store completion may not free up entries,
     // but hopefully avoids two store completions in one cycle from making
@@ -49,6 +49,7 @@
 #include <unordered_map>
 
 #include "base/statistics.hh"
+#include "cpu/inst_ring.hh"
 #include "cpu/inst_seq.hh"
 #include "debug/MemDepUnit.hh"
 
@@ -165,6 +166,8 @@ class MemDepUnit
   private:
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
+    typedef typename InstRing<DynInstPtr>::iterator InstListIt;
+
     class MemDepEntry;
 
     typedef std::shared_ptr<MemDepEntry> MemDepEntryPtr;
@@ -208,9 +211,6 @@ class MemDepUnit
         /** The instruction being tracked. */
         DynInstPtr inst;
 
-        /** The iterator to the instruction's location inside the list. */
-        ListIt listIt;
-
         /** A vector of any dependent instructions. */
         std::vector<MemDepEntryPtr> dependInsts;
 
@@ -245,7 +245,7 @@ class MemDepUnit
     MemDepHash memDepHash;
 
     /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstRing<DynInstPtr> instList[Impl::MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
     std::list<DynInstPtr> instsToReplay;
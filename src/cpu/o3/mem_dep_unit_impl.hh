@@ -73,7 +73,7 @@ MemDepUnit<MemDepPred, Impl>::~MemDepUnit()
 {
     for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
 
-        ListIt inst_list_it = instList[tid].begin();
+        InstListIt inst_list_it = instList[tid].begin();
 
         MemDepHashIt hash_it;
 
@@ -184,9 +184,7 @@ MemDepUnit<MemDepPred, Impl>::insert(DynInstPtr &inst)
     MemDepEntry::memdep_insert++;
 #endif
 
-    instList[tid].push_back(inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(inst->seqNum, inst);
 
     // Check any barriers and the dependence predictor for any
     // producing memrefs/stores.
@@ -282,9 +280,7 @@ MemDepUnit<MemDepPred, Impl>::insertNonSpec(DynInstPtr &inst)
 #endif
 
     // Add the instruction to the list.
-    instList[tid].push_back(inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(inst->seqNum, inst);
 
     // Might want to turn this part into an inline function or something.
     // It's shared between both insert functions.
@@ -333,9 +329,7 @@ MemDepUnit<MemDepPred, Impl>::insertBarrier(DynInstPtr &barr_inst)
 #endif
 
     // Add the instruction to the instruction list.
-    instList[tid].push_back(barr_inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(barr_inst->seqNum, barr_inst);
 }
 
 template <class MemDepPred, class Impl>
@@ -416,7 +410,7 @@ MemDepUnit<MemDepPred, Impl>::completed(DynInstPtr &inst)
 
     assert(hash_it != memDepHash.end());
 
-    instList[tid].erase((*hash_it).second->listIt);
+    instList[tid].erase(inst->seqNum);
 
     (*hash_it).second = NULL;
 
@@ -497,7 +491,7 @@ MemDepUnit<MemDepPred, Impl>::squash(const InstSeqNum &squashed_num,
         }
     }
 
-    ListIt squash_it = instList[tid].end();
+    InstListIt squash_it = instList[tid].end();
     --squash_it;
 
     MemDepHashIt hash_it;
@@ -588,7 +582,7 @@ MemDepUnit<MemDepPred, Impl>::dumpLists()
         cprintf("Instruction list %i size: %i\n",
                 tid, instList[tid].size());
 
-        ListIt inst_list_it = instList[tid].begin();
+        InstListIt inst_list_it = instList[tid].begin();
         int num = 0;
 
         while (inst_list_it != instList[tid].end()) {
@@ -55,7 +55,8 @@ class SimpleTrace : public ProbeListenerObject {
 
   public:
     SimpleTrace(const SimpleTraceParams *params):
-        ProbeListenerObject(params)
+        ProbeListenerObject(params),
+        traceName(ProbeListenerObject::name() + ".trace")
     {
     }
 
@@ -63,9 +64,11 @@ class SimpleTrace : public ProbeListenerObject {
     void regProbeListeners();
 
     /** Returns the name of the trace. */
-    const std::string name() const { return ProbeListenerObject::name() + ".trace"; }
+    const Trace::ObjectName &name() const override { return traceName; }
 
   private:
+    const Trace::ObjectName traceName;
+
     void traceFetch(const O3CPUImpl::DynInstPtr &dynInst);
     void traceCommit(const O3CPUImpl::DynInstPtr &dynInst);
 
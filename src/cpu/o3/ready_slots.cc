@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/ready_slots.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "base/bitfield.hh"
+#include "base/misc.hh"
+
+ReadySlots::ReadySlots(unsigned num_slots)
+    : numWords((num_slots + WordBits - 1) / WordBits),
+      seqNums(num_slots), opClasses(num_slots),
+      freeMask(numWords), readyMask(numWords),
+      classMask(numWords * Num_OpClasses), selectMask(numWords)
+{
+    assert(num_slots > 0);
+    clear();
+}
+
+int
+ReadySlots::allocate(InstSeqNum seq_num, OpClass op_class)
+{
+    for (unsigned w = 0; w < numWords; ++w) {
+        if (!freeMask[w])
+            continue;
+
+        int slot = w * WordBits + findLsbSet(freeMask[w]);
+        reset(freeMask.data(), slot);
+        seqNums[slot] = seq_num;
+        opClasses[slot] = op_class;
+        return slot;
+    }
+
+    panic("No free IQ slot\n");
+}
+
+void
+ReadySlots::release(int slot)
+{
+    assert(!test(freeMask, slot));
+    clearReady(slot);
+    set(freeMask.data(), slot);
+}
+
+void
+ReadySlots::clear()
+{
+    for (unsigned w = 0; w < numWords; ++w) {
+        unsigned left = numSlots() - w * WordBits;
+        freeMask[w] = left >= WordBits ? ~Word(0) : mask(left);
+        readyMask[w] = 0;
+        selectMask[w] = 0;
+    }
+    std::fill(classMask.begin(), classMask.end(), 0);
+}
+
+void
+ReadySlots::setReady(int slot)
+{
+    assert(!test(freeMask, slot));
+    set(readyMask.data(), slot);
+    set(classWords(opClasses[slot]), slot);
+}
+
+void
+ReadySlots::clearReady(int slot)
+{
+    reset(readyMask.data(), slot);
+    reset(classWords(opClasses[slot]), slot);
+    reset(selectMask.data(), slot);
+}
+
+bool
+ReadySlots::anyReady() const
+{
+    for (unsigned w = 0; w < numWords; ++w) {
+        if (readyMask[w])
+            return true;
+    }
+    return false;
+}
+
+unsigned
+ReadySlots::numReady() const
+{
+    unsigned num = 0;
+    for (unsigned w = 0; w < numWords; ++w)
+        num += popCount(readyMask[w]);
+    return num;
+}
+
+void
+ReadySlots::startSelect()
+{
+    selectMask = readyMask;
+}
+
+int
+ReadySlots::selectOldest()
+{
+    int oldest = -1;
+    InstSeqNum oldest_seq = std::numeric_limits<InstSeqNum>::max();
+
+    for (unsigned w = 0; w < numWords; ++w) {
+        for (Word bits = selectMask[w]; bits; bits &= bits - 1) {
+            int slot = w * WordBits + findLsbSet(bits);
+            if (seqNums[slot] < oldest_seq) {
+                oldest_seq = seqNums[slot];
+                oldest = slot;
+            }
+        }
+    }
+
+    if (oldest >= 0)
+        reset(selectMask.data(), oldest);
+    return oldest;
+}
+
+void
+ReadySlots::skipOpClass(OpClass op_class)
+{
+    const Word *class_words = classWords(op_class);
+    for (unsigned w = 0; w < numWords; ++w)
+        selectMask[w] &= ~class_words[w];
+}
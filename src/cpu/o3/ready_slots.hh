@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_READY_SLOTS_HH__
+#define __CPU_O3_READY_SLOTS_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+#include "cpu/op_class.hh"
+
+/**
+ * Bitmap based ready instruction selection for the instruction queue.
+ *
+ * Every instruction in the IQ holds a slot.  The slots of the
+ * instructions that are ready to issue are kept in a bitmap, as well as
+ * in one bitmap per op class, so waking an instruction up or issuing
+ * it is setting or clearing a bit.  A select round starts from a copy
+ * of the ready bitmap and repeatedly takes the oldest slot in it; an op
+ * class without a free FU is taken out of the round with one mask
+ * operation.  None of this depends on how many instructions wait in
+ * the IQ, only on how many are ready.
+ */
+class ReadySlots
+{
+  public:
+    /** @param num_slots Number of IQ entries. */
+    ReadySlots(unsigned num_slots);
+
+    unsigned numSlots() const { return seqNums.size(); }
+
+    /**
+     * Take a free slot for an instruction.  There must be one.
+     * @return The slot.
+     */
+    int allocate(InstSeqNum seq_num, OpClass op_class);
+
+    /** Free a slot, which also stops it from being ready. */
+    void release(int slot);
+
+    /** Free all the slots. */
+    void clear();
+
+    /** Mark a slot as ready to issue. */
+    void setReady(int slot);
+
+    /** Mark a slot as not ready, and take it out of the select round. */
+    void clearReady(int slot);
+
+    bool isReady(int slot) const { return test(readyMask, slot); }
+
+    bool anyReady() const;
+
+    unsigned numReady() const;
+
+    /** Sequence number of the instruction in a slot. */
+    InstSeqNum seqNum(int slot) const { return seqNums[slot]; }
+
+    /**
+     * @{
+     * @name Select
+     * startSelect() starts a round with all the ready slots;
+     * selectOldest() then hands them out, oldest first, taking each out
+     * of the round.  skipOpClass() drops the remaining slots of an op
+     * class from the round.
+     */
+    void startSelect();
+
+    /** @return The oldest slot left in the round, or -1. */
+    int selectOldest();
+
+    void skipOpClass(OpClass op_class);
+    /** @} */
+
+  private:
+    typedef uint64_t Word;
+
+    static const unsigned WordBits = 64;
+
+    /** Words in each bitmap. */
+    const unsigned numWords;
+
+    /** Sequence numbers of the instructions in the slots. */
+    std::vector<InstSeqNum> seqNums;
+
+    /** Op classes of the instructions in the slots. */
+    std::vector<OpClass> opClasses;
+
+    /** Slots that aren't allocated. */
+    std::vector<Word> freeMask;
+
+    /** Slots that are ready to issue. */
+    std::vector<Word> readyMask;
+
+    /** Ready slots of each op class, numWords words per op class. */
+    std::vector<Word> classMask;
+
+    /** Slots left in the current select round. */
+    std::vector<Word> selectMask;
+
+    static bool
+    test(const std::vector<Word> &mask, int slot)
+    {
+        return mask[slot / WordBits] & (Word(1) << (slot % WordBits));
+    }
+
+    static void
+    set(Word *mask, int slot)
+    {
+        mask[slot / WordBits] |= Word(1) << (slot % WordBits);
+    }
+
+    static void
+    reset(Word *mask, int slot)
+    {
+        mask[slot / WordBits] &= ~(Word(1) << (slot % WordBits));
+    }
+
+    Word *classWords(OpClass op_class)
+    { return &classMask[op_class * numWords]; }
+};
+
+#endif // __CPU_O3_READY_SLOTS_HH__
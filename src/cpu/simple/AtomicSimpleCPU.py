@@ -62,6 +62,10 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    superblock_cache = Param.Bool(False, "Run instructions from a cache "
+        "of pre-decoded blocks, without fetching them (for fast-forwarding)")
+    superblock_size = Param.Unsigned(64,
+        "Maximum number of instructions in a cached block")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
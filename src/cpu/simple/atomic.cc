@@ -43,6 +43,8 @@
 
 #include "cpu/simple/atomic.hh"
 
+#include <algorithm>
+
 #include "arch/locked_mem.hh"
 #include "arch/mmapped_ipr.hh"
 #include "arch/utility.hh"
@@ -82,12 +84,20 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      curBlock(nullptr), curBlockIdx(0), recordVPage(0),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       fastmem(p->fastmem), dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
     _status = Idle;
+
+    if (p->superblock_cache) {
+        fatal_if(numThreads > 1, "%s: the superblock cache doesn't support "
+                 "multiple threads.\n", name());
+        superblocks.reset(new SuperblockCache(p->superblock_size,
+                                              MaxSuperblocks));
+    }
 }
 
 
@@ -187,6 +197,9 @@ AtomicSimpleCPU::switchOut()
 {
     BaseSimpleCPU::switchOut();
 
+    // Don't hold on to the blocks while another CPU is running.
+    flushSuperblocks();
+
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isDrained());
@@ -486,6 +499,9 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    if (superblocks)
+                        invalidateSuperblocks(req->getPaddr(), size);
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -532,6 +548,19 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 }
 
 
+/**
+ * Instructions that may change how the code after them translates or
+ * decodes, e.g. by writing a control register or the page tables and
+ * flushing the TLB. Pipelined CPUs already have to serialize on them.
+ */
+static bool
+endsSuperblock(const StaticInstPtr &inst)
+{
+    return inst->isSerializing() || inst->isNonSpeculative() ||
+        inst->isSquashAfter() || inst->isIprAccess() || inst->isQuiesce() ||
+        inst->isSyscall();
+}
+
 void
 AtomicSimpleCPU::tick()
 {
@@ -552,124 +581,343 @@ AtomicSimpleCPU::tick()
     SimpleExecContext& t_info = *threadInfo[curThread];
     SimpleThread* thread = t_info.thread;
 
+    // Other CPUs and devices may have written the code of the block
+    // being run since the last tick.
+    if (curBlock)
+        checkSuperblockCode();
+
     Tick latency = 0;
 
-    for (int i = 0; i < width || locked; ++i) {
-        numCycles++;
-        ppCycles->notify(1);
+    do {
+        Tick cycle_latency = 0;
 
-        if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
-            checkForInterrupts();
-            checkPcEventQueue();
-        }
+        for (int i = 0; i < width || locked; ++i) {
+            numCycles++;
+            ppCycles->notify(1);
 
-        // We must have just got suspended by a PC event
-        if (_status == Idle) {
-            tryCompleteDrain();
-            return;
-        }
+            if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+                checkForInterrupts();
+                checkPcEventQueue();
+            }
 
-        Fault fault = NoFault;
+            // We must have just got suspended by a PC event
+            if (_status == Idle) {
+                tryCompleteDrain();
+                return;
+            }
 
-        TheISA::PCState pcState = thread->pcState();
+            Fault fault = NoFault;
+
+            TheISA::PCState pcState = thread->pcState();
+
+            bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
+                               !curMacroStaticInst;
+            const SuperblockCache::Inst *cached = nullptr;
+            if (needToFetch && superblocks)
+                cached = nextCachedInst(pcState);
+            if (needToFetch && !cached) {
+                ifetch_req.taskId(taskId());
+                setupFetchRequest(&ifetch_req);
+                fault = thread->itb->translateAtomic(&ifetch_req,
+                                                     thread->getTC(),
+                                                     BaseTLB::Execute);
+                if (fault == NoFault && superblocks &&
+                    t_info.fetchOffset == 0)
+                    cached = enterSuperblock(pcState);
+            }
 
-        bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
-                           !curMacroStaticInst;
-        if (needToFetch) {
-            ifetch_req.taskId(taskId());
-            setupFetchRequest(&ifetch_req);
-            fault = thread->itb->translateAtomic(&ifetch_req, thread->getTC(),
-                                                 BaseTLB::Execute);
-        }
+            if (fault == NoFault) {
+                Tick icache_latency = 0;
+                bool icache_access = false;
+                dcache_access = false; // assume no dcache access
+
+                if (needToFetch && !cached) {
+                    // This is commented out because the decoder would act
+                    // like a tiny cache otherwise. It wouldn't be flushed
+                    // when needed like the I cache. It should be flushed,
+                    // and when that works this code should be uncommented.
+                    //Fetch more instruction memory if necessary
+                    //if (decoder.needMoreBytes())
+                    //{
+                        icache_access = true;
+                        Packet ifetch_pkt = Packet(&ifetch_req,
+                                                   MemCmd::ReadReq);
+                        ifetch_pkt.dataStatic(&inst);
+
+                        if (fastmem &&
+                            system->isMemAddr(ifetch_pkt.getAddr()))
+                            system->getPhysMem().access(&ifetch_pkt);
+                        else
+                            icache_latency =
+                                icachePort.sendAtomic(&ifetch_pkt);
+
+                        assert(!ifetch_pkt.isError());
+
+                        if (superblocks && superblocks->recording()) {
+                            superblocks->recordCode(ifetch_req.getPaddr(),
+                                (const uint8_t *)&inst, ifetch_req.getSize());
+                        }
+
+                        // ifetch_req is initialized to read the
+                        // instruction directly into the CPU object's inst
+                        // field.
+                    //}
+                } else if (cached) {
+                    // Skip the fetch and decode.
+                    thread->pcState(cached->decodedPC);
+                    predecodedInst = cached->staticInst;
+                    ++superblockInsts;
+                }
 
-        if (fault == NoFault) {
-            Tick icache_latency = 0;
-            bool icache_access = false;
-            dcache_access = false; // assume no dcache access
-
-            if (needToFetch) {
-                // This is commented out because the decoder would act like
-                // a tiny cache otherwise. It wouldn't be flushed when needed
-                // like the I cache. It should be flushed, and when that works
-                // this code should be uncommented.
-                //Fetch more instruction memory if necessary
-                //if (decoder.needMoreBytes())
-                //{
-                    icache_access = true;
-                    Packet ifetch_pkt = Packet(&ifetch_req, MemCmd::ReadReq);
-                    ifetch_pkt.dataStatic(&inst);
-
-                    if (fastmem && system->isMemAddr(ifetch_pkt.getAddr()))
-                        system->getPhysMem().access(&ifetch_pkt);
-                    else
-                        icache_latency = icachePort.sendAtomic(&ifetch_pkt);
+                preExecute();
+
+                if (needToFetch && !cached && superblocks &&
+                    !t_info.stayAtPC)
+                    recordInst(pcState);
+
+                Tick stall_ticks = 0;
+                if (curStaticInst) {
+                    fault = curStaticInst->execute(&t_info, traceData);
+
+                    // keep an instruction count
+                    if (fault == NoFault) {
+                        countInst();
+                        ppCommit->notify(std::make_pair(thread,
+                                                        curStaticInst));
+                    }
+                    else if (traceData && !DTRACE(ExecFaulting)) {
+                        delete traceData;
+                        traceData = NULL;
+                    }
+
+                    if (dynamic_pointer_cast<SyscallRetryFault>(fault)) {
+                        // Retry execution of system calls after a delay.
+                        // Prevents immediate re-execution since conditions
+                        // which caused the retry are unlikely to change
+                        // every tick.
+                        stall_ticks +=
+                            clockEdge(syscallRetryLatency) - curTick();
+                    }
+
+                    postExecute();
+
+                    if (superblocks &&
+                        (fault != NoFault || endsSuperblock(curStaticInst)))
+                        leaveSuperblock();
+                }
+
+                // @todo remove me after debugging with legion done
+                if (curStaticInst && (!curStaticInst->isMicroop() ||
+                            curStaticInst->isFirstMicroop()))
+                    instCnt++;
 
-                    assert(!ifetch_pkt.isError());
+                if (simulate_inst_stalls && icache_access)
+                    stall_ticks += icache_latency;
 
-                    // ifetch_req is initialized to read the instruction directly
-                    // into the CPU object's inst field.
-                //}
+                if (simulate_data_stalls && dcache_access)
+                    stall_ticks += dcache_latency;
+
+                if (stall_ticks) {
+                    // the atomic cpu does its accounting in ticks, so
+                    // keep counting in ticks but round to the clock
+                    // period
+                    cycle_latency += divCeil(stall_ticks, clockPeriod()) *
+                        clockPeriod();
+                }
+
+            } else if (superblocks) {
+                leaveSuperblock();
             }
+            if (fault != NoFault || !t_info.stayAtPC)
+                advancePC(fault);
+        }
 
-            preExecute();
+        // instruction takes at least one cycle
+        if (cycle_latency < clockPeriod())
+            cycle_latency = clockPeriod();
+        latency += cycle_latency;
+    } while (superblocks && continueSuperblock(latency));
 
-            Tick stall_ticks = 0;
-            if (curStaticInst) {
-                fault = curStaticInst->execute(&t_info, traceData);
+    if (tryCompleteDrain())
+        return;
 
-                // keep an instruction count
-                if (fault == NoFault) {
-                    countInst();
-                    ppCommit->notify(std::make_pair(thread, curStaticInst));
-                }
-                else if (traceData && !DTRACE(ExecFaulting)) {
-                    delete traceData;
-                    traceData = NULL;
-                }
+    if (_status != Idle)
+        reschedule(tickEvent, curTick() + latency, true);
+}
 
-                if (dynamic_pointer_cast<SyscallRetryFault>(fault)) {
-                    // Retry execution of system calls after a delay.
-                    // Prevents immediate re-execution since conditions which
-                    // caused the retry are unlikely to change every tick.
-                    stall_ticks += clockEdge(syscallRetryLatency) - curTick();
-                }
+const SuperblockCache::Inst *
+AtomicSimpleCPU::nextCachedInst(const TheISA::PCState &pc)
+{
+    if (!curBlock)
+        return nullptr;
 
-                postExecute();
-            }
+    if (curBlockIdx < curBlock->insts.size() &&
+        curBlock->insts[curBlockIdx].pc == pc) {
+        return &curBlock->insts[curBlockIdx++];
+    }
 
-            // @todo remove me after debugging with legion done
-            if (curStaticInst && (!curStaticInst->isMicroop() ||
-                        curStaticInst->isFirstMicroop()))
-                instCnt++;
+    curBlock = nullptr;
+    return nullptr;
+}
 
-            if (simulate_inst_stalls && icache_access)
-                stall_ticks += icache_latency;
+const SuperblockCache::Inst *
+AtomicSimpleCPU::enterSuperblock(const TheISA::PCState &pc)
+{
+    SimpleThread *thread = threadInfo[curThread]->thread;
 
-            if (simulate_data_stalls && dcache_access)
-                stall_ticks += dcache_latency;
+    // The fetch request is for the aligned chunk holding the instruction.
+    Addr paddr = ifetch_req.getPaddr() +
+        (pc.instAddr() - ifetch_req.getVaddr());
 
-            if (stall_ticks) {
-                // the atomic cpu does its accounting in ticks, so
-                // keep counting in ticks but round to the clock
-                // period
-                latency += divCeil(stall_ticks, clockPeriod()) *
-                    clockPeriod();
-            }
+    // Code outside of memory, e.g. in a device ROM, can change without
+    // the CPU seeing a write.
+    if (!system->isMemAddr(paddr)) {
+        leaveSuperblock();
+        return nullptr;
+    }
 
+    uint64_t context = SuperblockCache::decoderContext(thread->getTC());
+    curBlock = superblocks->lookup(paddr, pc, context);
+    if (curBlock && superblocks->recording()) {
+        // Adding the recorded block may flush the cache.
+        superblocks->endBlock();
+        curBlock = superblocks->lookup(paddr, pc, context);
+    }
+    if (curBlock && checkSuperblockCode()) {
+        curBlockIdx = 1;
+        return &curBlock->insts[0];
+    }
+
+    ++superblockMisses;
+
+    const Addr vpage = pc.instAddr() & ~(TheISA::PageBytes - 1);
+    if (superblocks->recording()) {
+        const SuperblockCache::Block &block = superblocks->recordingBlock();
+        if (vpage == recordVPage && block.context == context &&
+            (paddr & ~(TheISA::PageBytes - 1)) ==
+            (block.paddr & ~(TheISA::PageBytes - 1))) {
+            return nullptr;
         }
-        if (fault != NoFault || !t_info.stayAtPC)
-            advancePC(fault);
+        superblocks->endBlock();
     }
 
-    if (tryCompleteDrain())
+    superblocks->startBlock(paddr, context);
+    recordVPage = vpage;
+    return nullptr;
+}
+
+void
+AtomicSimpleCPU::recordInst(const TheISA::PCState &pc)
+{
+    if (!superblocks->recording())
         return;
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
+    // An instruction fetched in several pieces may run into the next page.
+    if ((ifetch_req.getVaddr() & ~(TheISA::PageBytes - 1)) != recordVPage) {
+        superblocks->endBlock();
+        return;
+    }
 
-    if (_status != Idle)
-        reschedule(tickEvent, curTick() + latency, true);
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    superblocks->record(pc, thread->pcState(),
+                        curMacroStaticInst ? curMacroStaticInst :
+                                             curStaticInst);
+}
+
+void
+AtomicSimpleCPU::leaveSuperblock()
+{
+    curBlock = nullptr;
+    superblocks->endBlock();
+}
+
+void
+AtomicSimpleCPU::invalidateSuperblocks(Addr paddr, unsigned size)
+{
+    unsigned dropped = superblocks->invalidate(paddr, size);
+    if (dropped) {
+        DPRINTF(SimpleCPU, "Write to %#x dropped %d superblocks\n",
+                paddr, dropped);
+        superblockInvalidations += dropped;
+        curBlock = nullptr;
+    }
+}
+
+bool
+AtomicSimpleCPU::checkSuperblockCode()
+{
+    const SuperblockCache::Block &block = *curBlock;
+    const Addr code_addr = block.codeAddr;
+    const unsigned code_size = block.code.size();
+    superblockCode.resize(code_size);
+
+    // Read the code a cache line at a time, caches only look up the
+    // line at the start of a functional access.
+    const unsigned line_size = cacheLineSize();
+    for (unsigned offset = 0; offset < code_size; ) {
+        Addr addr = code_addr + offset;
+        unsigned size = std::min<Addr>(code_size - offset,
+                                       line_size - (addr & (line_size - 1)));
+        Request req(addr, size, Request::INST_FETCH, instMasterId());
+        Packet pkt(&req, MemCmd::ReadReq);
+        pkt.dataStatic(&superblockCode[offset]);
+        if (fastmem)
+            system->getPhysMem().functionalAccess(&pkt);
+        else
+            icachePort.sendFunctional(&pkt);
+        offset += size;
+    }
+
+    if (block.codeMatches(superblockCode.data()))
+        return true;
+
+    DPRINTF(SimpleCPU, "Code of the superblock at %#x changed\n",
+            block.paddr);
+    invalidateSuperblocks(code_addr, code_size);
+    curBlock = nullptr;
+    return false;
+}
+
+void
+AtomicSimpleCPU::flushSuperblocks()
+{
+    curBlock = nullptr;
+    if (superblocks)
+        superblocks->clear();
+}
+
+bool
+AtomicSimpleCPU::continueSuperblock(Tick latency) const
+{
+    if (!curBlock || curBlockIdx >= curBlock->insts.size() ||
+        _status != BaseSimpleCPU::Running ||
+        drainState() != DrainState::Running)
+        return false;
+
+    const EventQueue *queue = eventQueue();
+    return queue->empty() || queue->nextTick() > curTick() + latency;
+}
+
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    superblockInsts
+        .name(name() + ".superblockInsts")
+        .desc("Number of instructions run from the superblock cache")
+        ;
+
+    superblockMisses
+        .name(name() + ".superblockMisses")
+        .desc("Number of fetches that found no superblock")
+        ;
+
+    superblockInvalidations
+        .name(name() + ".superblockInvalidations")
+        .desc("Number of superblocks dropped because their code "
+              "changed")
+        ;
 }
 
 void
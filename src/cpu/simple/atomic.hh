@@ -43,8 +43,12 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+#include <vector>
+
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
+#include "cpu/simple/superblock_cache.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -58,6 +62,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     void init() override;
 
+    void regStats() override;
+
   private:
 
     EventFunctionWrapper tickEvent;
@@ -70,6 +76,69 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     // main simulation loop (one cycle)
     void tick();
 
+    /** Number of cached blocks at which the cache is flushed. */
+    static const unsigned MaxSuperblocks = 1 << 16;
+
+    /** Pre-decoded instruction blocks, or nullptr if not enabled. */
+    std::unique_ptr<SuperblockCache> superblocks;
+
+    /** The block being run from the cache, or nullptr. */
+    const SuperblockCache::Block *curBlock;
+
+    /** Index of the next instruction in curBlock. */
+    unsigned curBlockIdx;
+
+    /** Virtual page of the block being recorded. */
+    Addr recordVPage;
+
+    /**
+     * Take the next instruction of the block being run, if the thread
+     * is still following it.
+     * @return The instruction, or nullptr after leaving the block.
+     */
+    const SuperblockCache::Inst *nextCachedInst(const TheISA::PCState &pc);
+
+    /**
+     * Look up the block at the translated fetch address, and start
+     * running it. Without one, keep recording the current block if the
+     * instruction can be added to it, or start recording a new one.
+     * @return The first instruction of the block found, or nullptr.
+     */
+    const SuperblockCache::Inst *enterSuperblock(const TheISA::PCState &pc);
+
+    /** Add the instruction that was just fetched and decoded. */
+    void recordInst(const TheISA::PCState &pc);
+
+    /** Stop running and recording blocks. */
+    void leaveSuperblock();
+
+    /** Drop the blocks that a write to [paddr, paddr + size) changes. */
+    void invalidateSuperblocks(Addr paddr, unsigned size);
+
+    /** Scratch buffer for the code read by checkSuperblockCode(). */
+    std::vector<uint8_t> superblockCode;
+
+    /**
+     * Compare the code of curBlock with memory, and drop the blocks on
+     * its page if it changed.
+     * @return Whether curBlock is still valid.
+     */
+    bool checkSuperblockCode();
+
+    /** Drop all the blocks. */
+    void flushSuperblocks();
+
+    /**
+     * Check if the current tick can go on running the block after
+     * spending a latency: nothing else may happen before the CPU would
+     * have ticked again.
+     */
+    bool continueSuperblock(Tick latency) const;
+
+    Stats::Scalar superblockInsts;
+    Stats::Scalar superblockMisses;
+    Stats::Scalar superblockInvalidations;
+
     /**
      * Check if a system is in a drained state.
      *
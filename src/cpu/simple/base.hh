@@ -107,6 +107,13 @@ class BaseSimpleCPU : public BaseCPU
     StaticInstPtr curStaticInst;
     StaticInstPtr curMacroStaticInst;
 
+    /**
+     * An instruction decoded earlier, which preExecute() takes instead
+     * of decoding the fetched bytes. The PC state must already be the
+     * one the decoder would have produced.
+     */
+    StaticInstPtr predecodedInst;
+
   protected:
     enum Status {
         Idle,
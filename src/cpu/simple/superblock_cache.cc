@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/superblock_cache.hh"
+
+#include <cassert>
+#include <cstring>
+
+#include "arch/registers.hh"
+#include "config/the_isa.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/thread_context.hh"
+
+SuperblockCache::SuperblockCache(unsigned max_block_insts,
+                                 unsigned max_blocks)
+    : maxBlockInsts(max_block_insts), maxBlocks(max_blocks),
+      isRecording(false)
+{
+    assert(maxBlockInsts > 0);
+    building.insts.reserve(maxBlockInsts);
+}
+
+const SuperblockCache::Block *
+SuperblockCache::lookup(Addr paddr, const TheISA::PCState &pc,
+                        uint64_t context) const
+{
+    auto it = blocks.find(paddr);
+    if (it == blocks.end())
+        return nullptr;
+
+    const Block &block = it->second;
+    if (block.context != context || block.insts.front().pc != pc)
+        return nullptr;
+    return &block;
+}
+
+void
+SuperblockCache::startBlock(Addr paddr, uint64_t context)
+{
+    assert(!isRecording);
+    building.paddr = paddr;
+    building.context = context;
+    building.insts.clear();
+    building.codeAddr = paddr;
+    building.code.clear();
+    building.codeMask.clear();
+    isRecording = true;
+}
+
+void
+SuperblockCache::record(const TheISA::PCState &pc,
+                        const TheISA::PCState &decoded_pc,
+                        const StaticInstPtr &static_inst)
+{
+    assert(isRecording);
+    building.insts.push_back(Inst{pc, decoded_pc, static_inst});
+    if (building.insts.size() >= maxBlockInsts)
+        endBlock();
+}
+
+void
+SuperblockCache::recordCode(Addr paddr, const uint8_t *data, unsigned size)
+{
+    assert(isRecording);
+    if (pageOf(paddr) != pageOf(building.paddr) ||
+        pageOf(paddr + size - 1) != pageOf(building.paddr)) {
+        isRecording = false;
+        return;
+    }
+
+    if (building.code.empty()) {
+        building.codeAddr = paddr;
+    } else if (paddr < building.codeAddr) {
+        const unsigned grow = building.codeAddr - paddr;
+        building.code.insert(building.code.begin(), grow, 0);
+        building.codeMask.insert(building.codeMask.begin(), grow, 0);
+        building.codeAddr = paddr;
+    }
+
+    const unsigned offset = paddr - building.codeAddr;
+    if (building.code.size() < offset + size) {
+        building.code.resize(offset + size, 0);
+        building.codeMask.resize(offset + size, 0);
+    }
+    std::memcpy(&building.code[offset], data, size);
+    std::memset(&building.codeMask[offset], 0xff, size);
+}
+
+void
+SuperblockCache::endBlock()
+{
+    if (!isRecording)
+        return;
+    isRecording = false;
+
+    if (building.insts.empty())
+        return;
+
+    if (blocks.size() >= maxBlocks)
+        clear();
+
+    auto it = blocks.find(building.paddr);
+    if (it == blocks.end()) {
+        pageBlocks[pageOf(building.paddr)].push_back(building.paddr);
+        it = blocks.emplace(building.paddr, Block()).first;
+    }
+
+    // Copy rather than move so the recording buffer keeps its capacity.
+    Block &block = it->second;
+    block.paddr = building.paddr;
+    block.context = building.context;
+    block.insts.assign(building.insts.begin(), building.insts.end());
+    block.codeAddr = building.codeAddr;
+    block.code.assign(building.code.begin(), building.code.end());
+    block.codeMask.assign(building.codeMask.begin(),
+                          building.codeMask.end());
+}
+
+bool
+SuperblockCache::Block::codeMatches(const uint8_t *mem) const
+{
+    uint8_t diff = 0;
+    for (size_t i = 0; i < code.size(); ++i)
+        diff |= (mem[i] ^ code[i]) & codeMask[i];
+    return diff == 0;
+}
+
+unsigned
+SuperblockCache::invalidate(Addr paddr, unsigned size)
+{
+    unsigned dropped = 0;
+    const Addr last = pageOf(paddr + size - 1);
+    for (Addr page = pageOf(paddr); ; page += TheISA::PageBytes) {
+        if (isRecording && pageOf(building.paddr) == page)
+            isRecording = false;
+
+        auto it = pageBlocks.find(page);
+        if (it != pageBlocks.end()) {
+            for (Addr start : it->second)
+                dropped += blocks.erase(start);
+            pageBlocks.erase(it);
+        }
+
+        if (page == last)
+            break;
+    }
+    return dropped;
+}
+
+void
+SuperblockCache::clear()
+{
+    blocks.clear();
+    pageBlocks.clear();
+    isRecording = false;
+}
+
+uint64_t
+SuperblockCache::decoderContext(ThreadContext *tc)
+{
+#if THE_ISA == X86_ISA
+    return tc->readMiscRegNoEffect(X86ISA::MISCREG_M5_REG);
+#elif THE_ISA == ARM_ISA
+    ArmISA::FPSCR fpscr = tc->readMiscRegNoEffect(ArmISA::MISCREG_FPSCR);
+    return fpscr.len | (fpscr.stride << 3);
+#elif THE_ISA == SPARC_ISA
+    return tc->readMiscRegNoEffect(SparcISA::MISCREG_ASI);
+#else
+    return 0;
+#endif
+}
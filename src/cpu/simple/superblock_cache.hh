@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_SUPERBLOCK_CACHE_HH__
+#define __CPU_SIMPLE_SUPERBLOCK_CACHE_HH__
+
+#include <unordered_map>
+#include <vector>
+
+#include "arch/isa_traits.hh"
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "config/the_isa.hh"
+#include "cpu/static_inst_fwd.hh"
+
+class ThreadContext;
+
+/**
+ * Cache of pre-decoded instruction traces for the atomic CPU.
+ *
+ * A superblock is the sequence of instructions a thread decoded, in
+ * the order it executed them, starting at some physical PC and staying
+ * on one page. For every instruction it keeps the PC state the
+ * instruction was fetched with, the PC state the decoder handed on and
+ * the decoded StaticInst (the macroop for microcoded instructions).
+ * When the thread gets back to the start of a block, the CPU can run
+ * through it without translating, fetching or decoding, as long as
+ * the PC of each instruction matches the one recorded; the first
+ * mismatch leaves the block.
+ *
+ * Blocks are keyed by physical address, so a page remap simply leads
+ * to a different block (or none). Every block keeps a copy of the
+ * code it was decoded from, which the CPU compares with memory before
+ * running the block, since writes by other CPUs and devices aren't
+ * necessarily seen by this one. Writes by the CPU itself drop all the
+ * blocks on the page they write right away. What the decoder reads
+ * besides the PC and the instruction bytes, e.g. the x86 operating
+ * mode, is stored with each block and has to match as well.
+ */
+class SuperblockCache
+{
+  public:
+    /** An instruction of a block. */
+    struct Inst
+    {
+        /** PC state the instruction is fetched with. */
+        TheISA::PCState pc;
+        /** PC state after decoding the instruction. */
+        TheISA::PCState decodedPC;
+        /** The decoded instruction. */
+        StaticInstPtr staticInst;
+    };
+
+    struct Block
+    {
+        /** Physical address of the first instruction. */
+        Addr paddr;
+        /** Decoder context the block was decoded in. */
+        uint64_t context;
+        std::vector<Inst> insts;
+
+        /** Physical address of the first byte of code fetched. */
+        Addr codeAddr;
+        /**
+         * The code from codeAddr on, as it was fetched. The fetches of
+         * a block needn't be contiguous, so codeMask tells the bytes
+         * that were fetched (0xff) from the gaps (0).
+         */
+        std::vector<uint8_t> code;
+        std::vector<uint8_t> codeMask;
+
+        /**
+         * Check if the code is unchanged.
+         * @param mem The current code.size() bytes from codeAddr on.
+         */
+        bool codeMatches(const uint8_t *mem) const;
+    };
+
+    /**
+     * @param max_block_insts Maximum number of instructions in a block.
+     * @param max_blocks Number of blocks at which the cache is flushed.
+     */
+    SuperblockCache(unsigned max_block_insts, unsigned max_blocks);
+
+    /**
+     * Find the block starting at a physical address for a PC state and
+     * decoder context.
+     * @return The block, or nullptr.
+     */
+    const Block *lookup(Addr paddr, const TheISA::PCState &pc,
+                        uint64_t context) const;
+
+    /**
+     * @{
+     * @name Recording
+     * A block is recorded by starting it, recording the instructions
+     * as they are decoded and ending it, which adds it to the cache.
+     * Blocks are ended when they reach the maximum size.
+     */
+    void startBlock(Addr paddr, uint64_t context);
+
+    bool recording() const { return isRecording; }
+
+    /** The block being recorded. */
+    const Block &recordingBlock() const { return building; }
+
+    void record(const TheISA::PCState &pc, const TheISA::PCState &decoded_pc,
+                const StaticInstPtr &static_inst);
+
+    /**
+     * Add fetched code to the block being recorded. Code from another
+     * page abandons the block.
+     */
+    void recordCode(Addr paddr, const uint8_t *data, unsigned size);
+
+    void endBlock();
+    /** @} */
+
+    /**
+     * Drop the blocks on the pages [paddr, paddr + size) touches, and
+     * the block being recorded if it's on one of them.
+     * @return The number of blocks dropped.
+     */
+    unsigned invalidate(Addr paddr, unsigned size);
+
+    /** Drop all the blocks. */
+    void clear();
+
+    size_t size() const { return blocks.size(); }
+
+    /** Decoder context of a thread, as stored with the blocks. */
+    static uint64_t decoderContext(ThreadContext *tc);
+
+  private:
+    const unsigned maxBlockInsts;
+    const unsigned maxBlocks;
+
+    /** Blocks by the physical address of their first instruction. */
+    std::unordered_map<Addr, Block> blocks;
+
+    /** Start addresses of the blocks on each physical page. */
+    std::unordered_map<Addr, std::vector<Addr>> pageBlocks;
+
+    Block building;
+    bool isRecording;
+
+    static Addr pageOf(Addr paddr) { return paddr & ~(TheISA::PageBytes - 1); }
+};
+
+#endif // __CPU_SIMPLE_SUPERBLOCK_CACHE_HH__
@@ -977,7 +977,7 @@ TimingSimpleCPU::DcachePort::recvReqRetry()
 
 TimingSimpleCPU::IprEvent::IprEvent(Packet *_pkt, TimingSimpleCPU *_cpu,
     Tick t)
-    : pkt(_pkt), cpu(_cpu)
+    : PooledEvent(Default_Pri, AutoDelete), pkt(_pkt), cpu(_cpu)
 {
     cpu->schedule(this, t);
 }
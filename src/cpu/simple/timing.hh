@@ -318,7 +318,7 @@ class TimingSimpleCPU : public BaseSimpleCPU
 
     EventFunctionWrapper fetchEvent;
 
-    struct IprEvent : Event {
+    struct IprEvent : PooledEvent {
         Packet *pkt;
         TimingSimpleCPU *cpu;
         IprEvent(Packet *_pkt, TimingSimpleCPU *_cpu, Tick t);
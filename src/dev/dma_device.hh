@@ -249,8 +249,7 @@ class DmaCallback : public Drainable
     Event *getChunkEvent()
     {
         ++count;
-        return new EventFunctionWrapper([this]{ chunkComplete(); }, name(),
-                                        true);
+        return newOneShotEvent([this]{ chunkComplete(); }, "DmaCallback");
     }
 };
 
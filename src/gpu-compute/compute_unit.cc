@@ -669,7 +669,7 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
         return true;
     }
 
-    EventFunctionWrapper *mem_resp_event =
+    Event *mem_resp_event =
         computeUnit->memPort[index]->createMemRespEvent(pkt);
 
     DPRINTF(GPUPort, "CU%d: WF[%d][%d]: index %d, addr %#x received!\n",
@@ -844,7 +844,7 @@ ComputeUnit::sendRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
 
             // translation is done. Schedule the mem_req_event at the
             // appropriate cycle to send the timing memory request to ruby
-            EventFunctionWrapper *mem_req_event =
+            Event *mem_req_event =
                 memPort[index]->createMemReqEvent(pkt);
 
             DPRINTF(GPUPort, "CU%d: WF[%d][%d]: index %d, addr %#x data "
@@ -922,7 +922,7 @@ ComputeUnit::sendRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
 void
 ComputeUnit::sendSyncRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
 {
-    EventFunctionWrapper *mem_req_event =
+    Event *mem_req_event =
         memPort[index]->createMemReqEvent(pkt);
 
 
@@ -1224,7 +1224,7 @@ ComputeUnit::DTLBPort::recvTimingResp(PacketPtr pkt)
 
     // translation is done. Schedule the mem_req_event at the appropriate
     // cycle to send the timing memory request to ruby
-    EventFunctionWrapper *mem_req_event =
+    Event *mem_req_event =
         computeUnit->memPort[mp_index]->createMemReqEvent(new_pkt);
 
     DPRINTF(GPUPort, "CU%d: WF[%d][%d]: index %d, addr %#x data scheduled\n",
@@ -1237,20 +1237,20 @@ ComputeUnit::DTLBPort::recvTimingResp(PacketPtr pkt)
     return true;
 }
 
-EventFunctionWrapper*
+Event*
 ComputeUnit::DataPort::createMemReqEvent(PacketPtr pkt)
 {
-    return new EventFunctionWrapper(
+    return newOneShotEvent(
         [this, pkt]{ processMemReqEvent(pkt); },
-        "ComputeUnit memory request event", true);
+        "ComputeUnit memory request event");
 }
 
-EventFunctionWrapper*
+Event*
 ComputeUnit::DataPort::createMemRespEvent(PacketPtr pkt)
 {
-    return new EventFunctionWrapper(
+    return newOneShotEvent(
         [this, pkt]{ processMemRespEvent(pkt); },
-        "ComputeUnit memory response event", true);
+        "ComputeUnit memory response event");
 }
 
 void
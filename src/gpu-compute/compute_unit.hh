@@ -441,10 +441,10 @@ class ComputeUnit : public MemObject
         };
 
         void processMemReqEvent(PacketPtr pkt);
-        EventFunctionWrapper *createMemReqEvent(PacketPtr pkt);
+        Event *createMemReqEvent(PacketPtr pkt);
 
         void processMemRespEvent(PacketPtr pkt);
-        EventFunctionWrapper *createMemRespEvent(PacketPtr pkt);
+        Event *createMemRespEvent(PacketPtr pkt);
 
         std::deque<std::pair<PacketPtr, GPUDynInstPtr>> retries;
 
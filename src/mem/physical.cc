@@ -41,17 +41,27 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 
+#include "base/inifile.hh"
+#include "base/intmath.hh"
+#include "base/str.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -71,11 +81,21 @@
 
 using namespace std;
 
+const uint64_t PhysicalMemory::checkpointPageSize;
+const uint64_t PhysicalMemory::compressChunkSize;
+
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
+                               bool mmap_using_noreserve,
+                               bool incremental_checkpoint,
+                               StoreFormat store_format,
+                               unsigned compress_threads) :
     _name(_name), rangeCache(addrMap.end()), size(0),
-    mmapUsingNoReserve(mmap_using_noreserve)
+    mmapUsingNoReserve(mmap_using_noreserve),
+    incrementalCheckpoint(incremental_checkpoint),
+    storeFormat(store_format),
+    compressThreads(compress_threads ? compress_threads :
+                    max(thread::hardware_concurrency(), 1u))
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
@@ -180,6 +200,8 @@ PhysicalMemory::PhysicalMemory(const string& _name,
                            f->isConfReported(), f->isInAddrMap(),
                            f->isKvmMap());
     }
+
+    pageHashes.resize(backingStore.size());
 }
 
 void
@@ -320,6 +342,407 @@ PhysicalMemory::functionalAccess(PacketPtr pkt)
     }
 }
 
+/**
+ * Hash a page for the change detection of incremental checkpoints.
+ * Every step is a bijection of the state for a given word, so two
+ * pages differing in a single word never collide.
+ */
+static uint64_t
+hashPage(const uint8_t *page, uint64_t size)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, page + i, sizeof(w));
+        h = (h ^ w) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i)
+        h = (h ^ page[i]) * 0xc4ceb9fe1a85ec53ULL;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static vector<uint64_t>
+hashPages(const uint8_t *pmem, uint64_t size)
+{
+    const uint64_t page_size = PhysicalMemory::checkpointPageSize;
+    vector<uint64_t> hashes((size + page_size - 1) / page_size);
+    for (uint64_t i = 0; i < hashes.size(); ++i) {
+        hashes[i] = hashPage(pmem + i * page_size,
+                             min(page_size, size - i * page_size));
+    }
+    return hashes;
+}
+
+/**
+ * Path of a parent checkpoint as stored in an incremental checkpoint:
+ * relative to the child if they are in the same directory, such that
+ * a set of checkpoints can be moved together, and absolute otherwise.
+ */
+static string
+parentPath(const string &child_dir, const string &parent_dir)
+{
+    char *child = realpath(child_dir.c_str(), NULL);
+    char *parent = realpath(parent_dir.c_str(), NULL);
+    fatal_if(!child || !parent, "Can't resolve checkpoint directory '%s'\n",
+             child ? parent_dir : child_dir);
+
+    string child_path(child), parent_path(parent);
+    free(child);
+    free(parent);
+
+    const size_t child_sep = child_path.rfind('/');
+    const size_t parent_sep = parent_path.rfind('/');
+    if (child_path.compare(0, child_sep, parent_path, 0, parent_sep) == 0)
+        return "../" + parent_path.substr(parent_sep + 1);
+    return parent_path;
+}
+
+/** Resolve a parent path stored in the checkpoint in cpt_dir */
+static string
+resolveParent(const string &cpt_dir, const string &parent)
+{
+    return parent[0] == '/' ? parent : cpt_dir + "/" + parent;
+}
+
+static bool
+isZero(const uint8_t *data, uint64_t size)
+{
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, data + i, sizeof(w));
+        if (w)
+            return false;
+    }
+    for (; i < size; ++i) {
+        if (data[i])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Run fn(i) for every i in [0, n) on up to num_threads host threads.
+ * The calling thread takes part in the work.
+ */
+static void
+parallelFor(uint64_t n, unsigned num_threads,
+            const function<void(uint64_t)> &fn)
+{
+    atomic<uint64_t> next(0);
+    auto worker = [&]() {
+        for (uint64_t i = next++; i < n; i = next++)
+            fn(i);
+    };
+
+    vector<thread> threads;
+    for (uint64_t t = 1; t < min<uint64_t>(num_threads, n); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads)
+        t.join();
+}
+
+/** Compress a chunk of memory into a self-contained gzip member */
+static bool
+compressChunk(const uint8_t *data, uint64_t size, vector<uint8_t> &out)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // a window of 15 bits plus 16 selects the gzip wrapper
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    out.resize(deflateBound(&zs, size));
+    zs.next_in = const_cast<uint8_t *>(data);
+    zs.avail_in = size;
+    zs.next_out = out.data();
+    zs.avail_out = out.size();
+    const bool done = deflate(&zs, Z_FINISH) == Z_STREAM_END;
+    out.resize(zs.total_out);
+    return deflateEnd(&zs) == Z_OK && done;
+}
+
+/** Decompress a gzip member holding exactly size bytes */
+static bool
+decompressChunk(const vector<uint8_t> &in, uint8_t *data, uint64_t size)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 16) != Z_OK)
+        return false;
+
+    zs.next_in = const_cast<uint8_t *>(in.data());
+    zs.avail_in = in.size();
+    zs.next_out = data;
+    zs.avail_out = size;
+    const bool done = inflate(&zs, Z_FINISH) == Z_STREAM_END &&
+        zs.total_out == size;
+    return inflateEnd(&zs) == Z_OK && done;
+}
+
+/**
+ * Write a store as a sequence of independently compressed chunks,
+ * using num_threads host threads. The concatenated gzip members form
+ * a regular gzip file, so the store remains readable by gzip and by
+ * sequential readers. The compressed size of every chunk is returned
+ * to index the file for parallel decompression.
+ */
+static vector<uint64_t>
+writeChunkedStore(const string &filepath, const uint8_t *pmem,
+                  uint64_t range_size, uint64_t chunk_size,
+                  unsigned num_threads)
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    // compress a batch of chunks in parallel and write them in order,
+    // which bounds the memory held by compressed chunks
+    const uint64_t num_chunks = divCeil(range_size, chunk_size);
+    const uint64_t batch_size = 2 * num_threads;
+    vector<uint64_t> chunk_sizes(num_chunks);
+    vector<vector<uint8_t>> batch(batch_size);
+
+    for (uint64_t first = 0; first < num_chunks; first += batch_size) {
+        const uint64_t n = min(batch_size, num_chunks - first);
+        atomic<bool> failed(false);
+        parallelFor(n, num_threads, [&](uint64_t i) {
+            const uint64_t offset = (first + i) * chunk_size;
+            if (!compressChunk(pmem + offset,
+                               min(chunk_size, range_size - offset),
+                               batch[i]))
+                failed = true;
+        });
+        if (failed)
+            fatal("Compression failed on physical memory checkpoint file "
+                  "'%s'\n", filepath);
+
+        for (uint64_t i = 0; i < n; ++i) {
+            const vector<uint8_t> &chunk = batch[i];
+            for (uint64_t written = 0; written < chunk.size(); ) {
+                ssize_t ret = write(fd, chunk.data() + written,
+                                    chunk.size() - written);
+                if (ret < 0)
+                    fatal("Write failed on physical memory checkpoint file "
+                          "'%s': %s\n", filepath, strerror(errno));
+                written += ret;
+            }
+            chunk_sizes[first + i] = chunk.size();
+        }
+    }
+
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    return chunk_sizes;
+}
+
+/**
+ * Read a store written by writeChunkedStore(), decompressing its
+ * chunks in parallel. As for sequential reads, only the pages that
+ * are non-zero are written to the (zero-initialised) backing store.
+ */
+static void
+readChunkedStore(const string &filepath, uint8_t *pmem, uint64_t range_size,
+                 uint64_t chunk_size, const vector<uint64_t> &chunk_sizes,
+                 unsigned num_threads)
+{
+    if (chunk_sizes.size() != divCeil(range_size, chunk_size))
+        fatal("Bad chunk index of physical memory checkpoint file '%s'\n",
+              filepath);
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    vector<uint64_t> offsets(chunk_sizes.size());
+    for (uint64_t i = 1; i < offsets.size(); ++i)
+        offsets[i] = offsets[i - 1] + chunk_sizes[i - 1];
+
+    const uint64_t page_size = PhysicalMemory::checkpointPageSize;
+    atomic<bool> failed(false);
+    parallelFor(chunk_sizes.size(), num_threads, [&](uint64_t i) {
+        const uint64_t offset = i * chunk_size;
+        const uint64_t size = min(chunk_size, range_size - offset);
+        vector<uint8_t> in(chunk_sizes[i]);
+        vector<uint8_t> out(size);
+        if (pread(fd, in.data(), in.size(), offsets[i]) !=
+                (ssize_t)in.size() ||
+            !decompressChunk(in, out.data(), size)) {
+            failed = true;
+            return;
+        }
+
+        for (uint64_t p = 0; p < size; p += page_size) {
+            const uint64_t bytes = min(page_size, size - p);
+            if (!isZero(out.data() + p, bytes))
+                memcpy(pmem + offset + p, out.data() + p, bytes);
+        }
+    });
+
+    close(fd);
+    if (failed)
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+/**
+ * Read a full gzip compressed store, only writing the non-zero words
+ * to the (zero-initialised) backing store.
+ */
+static void
+readFullStore(const string &filepath, uint8_t *pmem, uint64_t range_size)
+{
+    const uint32_t chunk_size = 16384;
+
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
+    uint64_t curr_size = 0;
+    long* temp_page = new long[chunk_size];
+    long* pmem_current;
+    uint32_t bytes_read;
+    while (curr_size < range_size) {
+        bytes_read = gzread(compressed_mem, temp_page, chunk_size);
+        if (bytes_read == 0)
+            break;
+
+        assert(bytes_read % sizeof(long) == 0);
+
+        for (uint32_t x = 0; x < bytes_read / sizeof(long); x++) {
+            // Only copy bytes that are non-zero, so we don't give
+            // the VM system hell
+            if (*(temp_page + x) != 0) {
+                pmem_current = (long*)(pmem + curr_size + x * sizeof(long));
+                *pmem_current = *(temp_page + x);
+            }
+        }
+        curr_size += bytes_read;
+    }
+
+    delete[] temp_page;
+
+    if (gzclose(compressed_mem))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+/**
+ * Write an uncompressed image of a store, leaving pages of zeros as
+ * holes in the file.
+ */
+static void
+writeRawStore(const string &filepath, const uint8_t *pmem,
+              uint64_t range_size)
+{
+    const uint64_t page_size = PhysicalMemory::checkpointPageSize;
+
+    // Write a new file and move it in place of any existing one, which
+    // may still be mapped by a store restored from it
+    const string tmp_path = filepath + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s': %s\n",
+              tmp_path, strerror(errno));
+
+    uint64_t offset = 0;
+    while (offset < range_size) {
+        // skip the zero pages and write the next run of non-zero ones
+        while (offset < range_size &&
+               isZero(pmem + offset, min(page_size, range_size - offset)))
+            offset += page_size;
+        uint64_t end = offset;
+        while (end < range_size &&
+               !isZero(pmem + end, min(page_size, range_size - end)))
+            end += page_size;
+        end = min(end, range_size);
+
+        while (offset < end) {
+            ssize_t written = pwrite(fd, pmem + offset,
+                                     min<uint64_t>(end - offset, INT_MAX),
+                                     offset);
+            if (written < 0)
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s': %s\n", tmp_path, strerror(errno));
+            offset += written;
+        }
+    }
+
+    if (ftruncate(fd, range_size) != 0 || close(fd) != 0 ||
+        rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+        fatal("Close failed on physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+    }
+}
+
+/**
+ * Map an uncompressed image copy-on-write in place of the backing
+ * store. Pages are only read from the file when first touched, and
+ * writes to them never reach the file.
+ */
+static void
+mapRawStore(const string &filepath, uint8_t *pmem, uint64_t range_size)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < range_size)
+        fatal("Physical memory checkpoint file '%s' is too short\n",
+              filepath);
+
+    if (mmap(pmem, range_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) == (void *)MAP_FAILED)
+        fatal("Could not mmap physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    close(fd);
+}
+
+/**
+ * Apply the pages of an incremental store on top of the restored
+ * contents of its parent. The store is a gzip compressed sequence of
+ * changed pages, each preceded by its 64-bit page number.
+ */
+static void
+readDeltaStore(const string &filepath, uint8_t *pmem, uint64_t range_size)
+{
+    const uint64_t page_size = PhysicalMemory::checkpointPageSize;
+
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
+    uint64_t page;
+    while (gzread(compressed_mem, &page, sizeof(page)) == (int)sizeof(page)) {
+        fatal_if(page * page_size >= range_size,
+                 "Page %d out of range in physical memory checkpoint "
+                 "file '%s'\n", page, filepath);
+        const int bytes = min(page_size, range_size - page * page_size);
+        if (gzread(compressed_mem, pmem + page * page_size, bytes) != bytes)
+            fatal("Truncated physical memory checkpoint file '%s'\n",
+                  filepath);
+    }
+
+    if (gzclose(compressed_mem))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
 void
 PhysicalMemory::serialize(CheckpointOut &cp) const
 {
@@ -348,6 +771,9 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
         ScopedCheckpointSection sec(cp, csprintf("store%d", store_id));
         serializeStore(cp, store_id++, s.range, s.pmem);
     }
+
+    if (incrementalCheckpoint)
+        parentCheckpoint = CheckpointIn::dir();
 }
 
 void
@@ -366,27 +792,68 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
 
+    // find the pages that changed since the parent checkpoint, if any
+    vector<uint64_t> hashes;
+    vector<uint64_t> &parent_hashes = pageHashes[store_id];
+    if (incrementalCheckpoint)
+        hashes = hashPages(pmem, range.size());
+    const bool delta = incrementalCheckpoint && !parentCheckpoint.empty() &&
+        parent_hashes.size() == hashes.size();
+
+    if (delta) {
+        string format = "delta";
+        string parent = parentPath(CheckpointIn::dir(), parentCheckpoint);
+        SERIALIZE_SCALAR(format);
+        SERIALIZE_SCALAR(parent);
+    }
+
     // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+
+    if (!delta && storeFormat == RawStore) {
+        string format = "raw";
+        SERIALIZE_SCALAR(format);
+        writeRawStore(filepath, pmem, range.size());
+        parent_hashes = std::move(hashes);
+        return;
+    }
+
+    if (!delta) {
+        uint64_t chunk_size = compressChunkSize;
+        vector<uint64_t> chunk_sizes =
+            writeChunkedStore(filepath, pmem, range.size(), chunk_size,
+                              compressThreads);
+        SERIALIZE_SCALAR(chunk_size);
+        SERIALIZE_CONTAINER(chunk_sizes);
+        parent_hashes = std::move(hashes);
+        return;
+    }
+
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
               filename);
 
-    uint64_t pass_size = 0;
-
-    // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
-
-        if (gzwrite(compressed_mem, pmem + written,
-                    (unsigned int) pass_size) != (int) pass_size) {
-            fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+    const uint64_t page_size = checkpointPageSize;
+    uint64_t dirty_pages = 0;
+    for (uint64_t page = 0; page < hashes.size(); ++page) {
+        if (hashes[page] == parent_hashes[page])
+            continue;
+
+        const int bytes = min(page_size, range.size() - page * page_size);
+        if (gzwrite(compressed_mem, &page, sizeof(page)) !=
+                (int)sizeof(page) ||
+            gzwrite(compressed_mem, pmem + page * page_size, bytes) !=
+                bytes) {
+            fatal("Write failed on physical memory checkpoint file "
+                  "'%s'\n", filename);
         }
+        ++dirty_pages;
     }
+    SERIALIZE_SCALAR(dirty_pages);
+
+    DPRINTF(Checkpoint, "Wrote %d of %d pages of %s incrementally\n",
+            dirty_pages, hashes.size(), filename);
 
     // close the compressed stream and check that the exit status
     // is zero
@@ -394,6 +861,7 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
 
+    parent_hashes = std::move(hashes);
 }
 
 void
@@ -419,13 +887,13 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
         unserializeStore(cp);
     }
 
+    if (incrementalCheckpoint)
+        parentCheckpoint = cp.cptDir;
 }
 
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -433,11 +901,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.cptDir + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -452,31 +915,90 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
-    uint64_t curr_size = 0;
-    long* temp_page = new long[chunk_size];
-    long* pmem_current;
-    uint32_t bytes_read;
-    while (curr_size < range.size()) {
-        bytes_read = gzread(compressed_mem, temp_page, chunk_size);
-        if (bytes_read == 0)
-            break;
+    string format = "gzip";
+    optParamIn(cp, "format", format, false);
+
+    if (format == "delta") {
+        string parent;
+        UNSERIALIZE_SCALAR(parent);
+        restoreStoreChain(resolveParent(cp.cptDir, parent),
+                          Serializable::currentSection(), pmem, range_size);
+        readDeltaStore(filepath, pmem, range_size);
+    } else if (format == "gzip") {
+        // stores written in chunks are indexed for parallel reads
+        uint64_t chunk_size;
+        vector<uint64_t> chunk_sizes;
+        if (optParamIn(cp, "chunk_size", chunk_size, false)) {
+            UNSERIALIZE_CONTAINER(chunk_sizes);
+            readChunkedStore(filepath, pmem, range_size, chunk_size,
+                             chunk_sizes, compressThreads);
+        } else {
+            readFullStore(filepath, pmem, range_size);
+        }
+    } else if (format == "raw") {
+        mapRawStore(filepath, pmem, range_size);
+    } else {
+        fatal("Unknown format '%s' of physical memory checkpoint file '%s'\n",
+              format, filename);
+    }
 
-        assert(bytes_read % sizeof(long) == 0);
+    if (incrementalCheckpoint)
+        pageHashes[store_id] = hashPages(pmem, range_size);
+}
 
-        for (uint32_t x = 0; x < bytes_read / sizeof(long); x++) {
-            // Only copy bytes that are non-zero, so we don't give
-            // the VM system hell
-            if (*(temp_page + x) != 0) {
-                pmem_current = (long*)(pmem + curr_size + x * sizeof(long));
-                *pmem_current = *(temp_page + x);
+void
+PhysicalMemory::restoreStoreChain(const string &cpt_dir,
+                                  const string &section,
+                                  uint8_t *pmem, uint64_t range_size)
+{
+    IniFile db;
+    if (!db.load(cpt_dir + "/" + CheckpointIn::baseFilename))
+        fatal("Can't load checkpoint '%s' of an incremental checkpoint, "
+              "it may need flattening with util/cpt_flatten.py\n", cpt_dir);
+
+    string filename, size_str, format = "gzip", parent;
+    uint64_t parent_size;
+    if (!db.find(section, "filename", filename) ||
+        !db.find(section, "range_size", size_str) ||
+        !to_number(size_str, parent_size) || parent_size != range_size) {
+        fatal("Section %s of parent checkpoint '%s' does not match\n",
+              section, cpt_dir);
+    }
+
+    DPRINTF(Checkpoint, "Restoring parent physical memory %s/%s\n",
+            cpt_dir, filename);
+
+    db.find(section, "format", format);
+    if (format == "delta") {
+        if (!db.find(section, "parent", parent))
+            fatal("No parent in section %s of checkpoint '%s'\n",
+                  section, cpt_dir);
+        restoreStoreChain(resolveParent(cpt_dir, parent), section,
+                          pmem, range_size);
+        readDeltaStore(cpt_dir + "/" + filename, pmem, range_size);
+    } else if (format == "gzip") {
+        string chunk_str, sizes_str;
+        uint64_t chunk_size;
+        if (db.find(section, "chunk_size", chunk_str) &&
+            db.find(section, "chunk_sizes", sizes_str) &&
+            to_number(chunk_str, chunk_size)) {
+            vector<string> tokens;
+            tokenize(tokens, sizes_str, ' ');
+            vector<uint64_t> chunk_sizes(tokens.size());
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                if (!to_number(tokens[i], chunk_sizes[i]))
+                    fatal("Bad chunk index in section %s of checkpoint "
+                          "'%s'\n", section, cpt_dir);
             }
+            readChunkedStore(cpt_dir + "/" + filename, pmem, range_size,
+                             chunk_size, chunk_sizes, compressThreads);
+        } else {
+            readFullStore(cpt_dir + "/" + filename, pmem, range_size);
         }
-        curr_size += bytes_read;
+    } else if (format == "raw") {
+        mapRawStore(cpt_dir + "/" + filename, pmem, range_size);
+    } else {
+        fatal("Unknown format '%s' of physical memory checkpoint file '%s'\n",
+              format, filename);
     }
-
-    delete[] temp_page;
-
-    if (gzclose(compressed_mem))
-        fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
 }
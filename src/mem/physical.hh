@@ -112,6 +112,16 @@ class BackingStoreEntry
 class PhysicalMemory : public Serializable
 {
 
+  public:
+
+    /** Format of the full memory images written to checkpoints */
+    enum StoreFormat {
+        /** gzip compressed image */
+        GzipStore,
+        /** Sparse uncompressed image, mapped copy-on-write on restore */
+        RawStore
+    };
+
   private:
 
     // Name for debugging
@@ -133,6 +143,22 @@ class PhysicalMemory : public Serializable
     // Let the user choose if we reserve swap space when calling mmap
     const bool mmapUsingNoReserve;
 
+    // Only write the pages that changed since the previous checkpoint
+    const bool incrementalCheckpoint;
+
+    // Format of full memory images in checkpoints
+    const StoreFormat storeFormat;
+
+    // Host threads compressing and decompressing full memory images
+    const unsigned compressThreads;
+
+    // Checkpoint directory the memory was last written to or restored
+    // from, the parent of the next incremental checkpoint
+    mutable std::string parentCheckpoint;
+
+    // Hash of every page of each backing store at that checkpoint
+    mutable std::vector<std::vector<uint64_t>> pageHashes;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -157,14 +183,36 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Restore a backing store from a checkpoint that may be an
+     * incremental one, by first restoring its chain of parents.
+     *
+     * @param cpt_dir Directory of the checkpoint
+     * @param section Checkpoint section of the store
+     * @param pmem The host pointer to the backing store
+     * @param range_size Size of the backing store
+     */
+    void restoreStoreChain(const std::string &cpt_dir,
+                           const std::string &section,
+                           uint8_t *pmem, uint64_t range_size);
+
   public:
 
+    /** Granularity at which incremental checkpoints track changes */
+    static const uint64_t checkpointPageSize = 4096;
+
+    /** Size of the independently compressed chunks of a memory image */
+    static const uint64_t compressChunkSize = 4 * 1024 * 1024;
+
     /**
      * Create a physical memory object, wrapping a number of memories.
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve,
+                   bool incremental_checkpoint = false,
+                   StoreFormat store_format = GzipStore,
+                   unsigned compress_threads = 0);
 
     /**
      * Unmap all the backing store we have used.
@@ -248,7 +296,11 @@ class PhysicalMemory : public Serializable
     void serialize(CheckpointOut &cp) const override;
 
     /**
-     * Serialize a specific store.
+     * Serialize a specific store. In incremental mode, only the pages
+     * that changed since the checkpoint the memory was last written
+     * to or restored from are stored, together with a reference to
+     * that parent checkpoint. The first checkpoint is always a full
+     * one. Full images are written in the configured store format.
      *
      * @param store_id Unique identifier of this backing store
      * @param range The address range of this backing store
@@ -266,6 +318,9 @@ class PhysicalMemory : public Serializable
 
     /**
      * Unserialize a specific backing store, identified by a section.
+     * An incremental store is rebuilt from its chain of parents. A
+     * raw image is mapped copy-on-write in place of the backing store
+     * rather than read.
      */
     void unserializeStore(CheckpointIn &cp);
 
@@ -50,6 +50,7 @@
 
 #include "base/trace.hh"
 #include "mem/mem_object.hh"
+#include "sim/eventq_partition.hh"
 
 Port::Port(const std::string &_name, MemObject& _owner, PortID _id)
     : portName(_name), id(_id), owner(_owner)
@@ -166,6 +167,8 @@ Tick
 MasterPort::sendAtomic(PacketPtr pkt)
 {
     assert(pkt->isRequest());
+    if (EventqPartition::profiling)
+        EventqPartition::recordTraffic(&owner, &_slavePort->getOwner());
     return _slavePort->recvAtomic(pkt);
 }
 
@@ -180,6 +183,8 @@ bool
 MasterPort::sendTimingReq(PacketPtr pkt)
 {
     assert(pkt->isRequest());
+    if (EventqPartition::profiling)
+        EventqPartition::recordTraffic(&owner, &_slavePort->getOwner());
     return _slavePort->recvTimingReq(pkt);
 }
 
@@ -251,6 +256,8 @@ bool
 SlavePort::sendTimingResp(PacketPtr pkt)
 {
     assert(pkt->isResponse());
+    if (EventqPartition::profiling)
+        EventqPartition::recordTraffic(&owner, &_masterPort->getOwner());
     return _masterPort->recvTimingResp(pkt);
 }
 
@@ -41,10 +41,7 @@ Consumer::scheduleEventAbsolute(Tick evt_time)
 {
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
-        auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
-
-        em->schedule(evt, evt_time);
+        em->scheduleOneShot([this]{ wakeup(); }, "Consumer Event", evt_time);
         insertScheduledWakeupTime(evt_time);
     }
 
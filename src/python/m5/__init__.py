@@ -46,6 +46,8 @@ if in_gem5:
     import core
     import objects
     import params
+    import partition
+    import sampling
     import stats
     import util
 
@@ -131,8 +131,20 @@ def parse_options():
         help="End debug output at TICK")
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug [Default: %default]")
+    option("--debug-window", metavar="START:END", action='append', split=',',
+        help="Only trace between ticks START and END, may be given "
+             "several times")
+    option("--debug-objects", metavar="EXPR", action='append', split=':',
+        help="Only trace EXPR sim objects")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
+    option("--debug-format", type='choice', choices=['text', 'binary'],
+        default='text',
+        help="Write debug output as text or in a binary form, rendered "
+             "by util/trace_decoder [Default: %default]")
+    option("--debug-flight-recorder", metavar="MB", type='int', default=0,
+        help="Only keep the last MB megabytes of binary debug output, "
+             "written at exit, panic or fatal [Default: all output]")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
 
@@ -383,19 +395,41 @@ def main(*args):
             else:
                 debug.flags[flag].enable()
 
-    if options.debug_start:
+    def trace_at(when, func):
         check_tracing()
-        e = event.create(trace.enable, event.Event.Debug_Enable_Pri)
-        event.mainq.schedule(e, options.debug_start)
-    else:
+        e = event.create(func, event.Event.Debug_Enable_Pri)
+        event.mainq.schedule(e, when)
+
+    if options.debug_start:
+        trace_at(options.debug_start, trace.enable)
+    elif not options.debug_window:
         trace.enable()
 
     if options.debug_end:
-        check_tracing()
-        e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
-        event.mainq.schedule(e, options.debug_end)
+        trace_at(options.debug_end, trace.disable)
 
-    trace.output(options.debug_file)
+    for window in options.debug_window:
+        try:
+            start, end = [ int(tick) for tick in window.split(':') ]
+        except ValueError:
+            fatal("invalid debug window '%s', expected START:END", window)
+        trace_at(start, trace.enable)
+        trace_at(end, trace.disable)
+
+    if options.debug_format == 'binary':
+        debug_file = options.debug_file
+        if debug_file in ('cout', 'cerr'):
+            debug_file = 'trace.bin'
+        trace.output_binary(debug_file,
+                            options.debug_flight_recorder * 1024 * 1024)
+    else:
+        if options.debug_flight_recorder:
+            fatal("--debug-flight-recorder needs --debug-format=binary")
+        trace.output(options.debug_file)
+
+    for expr in options.debug_objects:
+        check_tracing()
+        trace.select(expr)
 
     for ignore in options.debug_ignore:
         check_tracing()
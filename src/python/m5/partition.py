@@ -0,0 +1,206 @@
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Partition the SimObjects of a simulated system over the main event
+queues.
+
+A partition is computed from a short profile of the simulation:
+
+    m5.partition.startProfile()
+    m5.simulate(warmup_ticks)
+    m5.partition.stopProfile(num_queues=4)
+    m5.checkpoint(cpt_dir)
+
+The profile counts the events scheduled by every SimObject, which is
+used as its load, and the packets sent between every pair of objects
+connected by ports. Objects whose connection carries a large part of
+their traffic (e.g., a CPU and its L1 caches) are clustered on the
+same queue as long as the cluster does not outgrow the load of a
+queue, and the clusters are then balanced over the queues, heaviest
+first. Objects that do not communicate through ports follow their
+closest communicating ancestor.
+
+The last computed partition is stored with every checkpoint taken
+afterwards, and is applied to the configuration when instantiating
+from that checkpoint unless Root.eventq_partition is False. The
+simulation quantum still has to be set in the restoring configuration
+and must not exceed the latency of any connection cut by the
+partition.
+"""
+
+import json
+import os
+
+import _m5.event
+
+from m5.util import fatal, inform
+
+# Name of the partition file in a checkpoint directory
+partition_file = 'eventq_partition.json'
+
+# The last partition computed from a profile
+current = None
+
+def startProfile():
+    """Start recording the event load and the communication of the
+    SimObjects."""
+    _m5.event.startPartitionProfile()
+
+def stopProfile(num_queues, coupling=0.25, slack=0.1):
+    """Stop recording and partition the objects over num_queues event
+    queues. Two objects are clustered if the packets between them are
+    at least a fraction coupling of the packets of one of them, and
+    the cluster stays within (1 + slack) times the load of a queue.
+    Returns the partition, which becomes the current one."""
+    import objects
+    global current
+
+    _m5.event.stopPartitionProfile()
+
+    root = objects.Root.getInstance()
+    load = {}
+    for obj in root.descendants():
+        if obj is not root and not obj.abstract:
+            load[obj.path()] = _m5.event.partitionEvents(obj.getCCObject())
+
+    current = partition(root, load, _m5.event.partitionTraffic(),
+                        num_queues, coupling, slack)
+    return current
+
+def partition(root, load, traffic, num_queues, coupling=0.25, slack=0.1):
+    """Compute a partition of the objects below root from the load of
+    every object (a dict from path to event count) and their traffic
+    (a list of (path, path, packets) tuples)."""
+
+    if num_queues < 1:
+        fatal("Can not partition over %d event queues", num_queues)
+
+    # Clusters of coupled objects, kept as a union-find forest with
+    # the load of every cluster at its representative
+    cluster = {}
+    cluster_load = {}
+    def find(path):
+        while cluster[path] != path:
+            cluster[path] = cluster[cluster[path]]
+            path = cluster[path]
+        return path
+
+    # Total packets sent and received by every object
+    packets_of = {}
+    for a, b, packets in traffic:
+        for path in a, b:
+            if path not in cluster:
+                cluster[path] = path
+                cluster_load[path] = load.get(path, 0)
+            packets_of[path] = packets_of.get(path, 0) + packets
+
+    # Objects are coupled if their connection carries a large fraction
+    # of the traffic of at least one of them. The most heavily
+    # communicating objects are merged first, as long as the cluster
+    # does not outgrow the load of a queue (or of the busiest object,
+    # whichever is larger).
+    total = sum(load.itervalues())
+    capacity = max([ total / float(num_queues) ] + load.values()) * \
+               (1 + slack)
+    for a, b, packets in sorted(traffic, key=lambda t: (-t[2], t[0], t[1])):
+        if packets < coupling * min(packets_of[a], packets_of[b]):
+            continue
+        a, b = find(a), find(b)
+        if a != b and cluster_load[a] + cluster_load[b] <= capacity:
+            cluster[a] = b
+            cluster_load[b] += cluster_load.pop(a)
+
+    # Objects that schedule events but do not communicate through
+    # ports are attributed to their closest profiled ancestor, which
+    # keeps e.g. TLBs and interrupt controllers with their CPU.
+    owner = { root.path() : None }
+    for obj in root.descendants():
+        if obj is root:
+            continue
+        path = obj.path()
+        owner[path] = find(path) if path in cluster else \
+                      owner[obj._parent.path()]
+
+    unowned_load = 0
+    for path, events in load.iteritems():
+        if owner[path] is None:
+            unowned_load += events
+        elif path not in cluster:
+            cluster_load[owner[path]] += events
+
+    # Longest processing time first, the unowned objects stay with the
+    # root on queue 0
+    queue_load = [ 0 ] * num_queues
+    queue_load[0] = unowned_load
+    queue = {}
+    for c in sorted(cluster_load, key=lambda c: (-cluster_load[c], c)):
+        q = queue_load.index(min(queue_load))
+        queue[c] = q
+        queue_load[q] += cluster_load[c]
+
+    assignment = {}
+    for path, c in owner.iteritems():
+        if path != root.path():
+            assignment[path] = queue.get(c, 0)
+
+    if total:
+        inform("Event queue partition: %d clusters over %d queues, "
+               "load imbalance %.2f", len(cluster_load), num_queues,
+               max(queue_load) * num_queues / float(total))
+
+    return { 'num_queues' : num_queues,
+             'load' : queue_load,
+             'assignment' : assignment }
+
+def apply(root, part):
+    """Set the eventq_index of the objects below root to the ones in a
+    partition. Must be called before the configuration is
+    instantiated."""
+    for obj in root.descendants():
+        index = part['assignment'].get(obj.path())
+        if index is not None:
+            obj.eventq_index = index
+
+    if part['num_queues'] > 1 and not int(root.sim_quantum):
+        fatal("Restoring a partition over %d event queues requires "
+              "Root.sim_quantum to be set", part['num_queues'])
+
+def write(part, dir):
+    """Store a partition in a (checkpoint) directory."""
+    f = open(os.path.join(dir, partition_file), 'w')
+    json.dump(part, f, indent=4, sort_keys=True)
+    f.close()
+
+def read(dir):
+    """Read the partition stored in a directory, None if there is
+    none."""
+    path = os.path.join(dir, partition_file)
+    if not os.path.isfile(path):
+        return None
+    f = open(path)
+    part = json.load(f)
+    f.close()
+    return part
@@ -0,0 +1,273 @@
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Sample a simulation by forking detailed simulations off a fast one.
+
+The parent process simulates the whole workload with a fast CPU (e.g.,
+AtomicSimpleCPU). At every sample point it forks a child, which
+inherits a copy-on-write image of the simulator. The child switches to
+the detailed CPUs, simulates a warm-up period, resets the stats,
+simulates the measured period and dumps its stats to its own output
+directory, while the parent carries on fast-forwarding:
+
+    m5.disableAllListeners()
+    m5.instantiate()
+    m5.sampling.run(system, [(fast_cpu, detailed_cpu)],
+                    period=1000000000, warmup=10000000, length=10000000)
+
+Up to a given number of children run at the same time, so a single
+workload can use all the host cores. Once the workload has finished,
+the stats of all the samples are aggregated into a report in the
+output directory of the parent, giving the mean of every stat over the
+samples together with its standard deviation and the 95% confidence
+interval of the mean.
+"""
+
+import math
+import os
+import re
+
+import _m5.core
+
+import m5
+from m5.util import fatal, inform, warn
+
+# Name of the report in the output directory of the parent
+report_name = "samples.txt"
+
+# Output directory of every sample, relative to the parent's
+sample_outdir = "sample%d"
+
+def _host_cores():
+    try:
+        import multiprocessing
+        return multiprocessing.cpu_count()
+    except NotImplementedError:
+        return 1
+
+_stat_re = re.compile(r"^(\S+)\s+(\S+)(?:\s+(?:\S+\s+)*?#\s*(.*))?$")
+
+def readStats(filename):
+    """Read the last dump of a text stats file.
+
+    Returns a dictionary mapping the name of every stat that has a
+    numerical value to a (value, description) tuple. Distributions and
+    other multi-column stats only contribute their first value.
+    """
+
+    stats = {}
+    try:
+        f = open(filename)
+    except IOError:
+        return stats
+
+    for line in f:
+        if line.startswith("---------- Begin"):
+            stats = {}
+            continue
+
+        match = _stat_re.match(line.strip())
+        if not match:
+            continue
+
+        name, value, desc = match.groups()
+        try:
+            stats[name] = (float(value), desc or "")
+        except ValueError:
+            pass
+
+    f.close()
+    return stats
+
+class Sample(object):
+    def __init__(self, index, tick, pid, outdir):
+        self.index = index
+        self.tick = tick
+        self.pid = pid
+        self.outdir = outdir
+        self.stats = None
+
+def _measure(system, switch_cpu_list, warmup, length):
+    """Simulate a sample in a child and never return."""
+
+    code = 0
+    try:
+        m5.switchCpus(system, switch_cpu_list)
+        if warmup:
+            m5.simulate(warmup)
+        m5.stats.reset()
+        event = m5.simulate(length)
+        m5.stats.dump()
+        m5.stats.flush()
+        if event.getCause() != "simulate() limit reached":
+            inform("Sample ended early @ tick %i because %s",
+                   m5.curTick(), event.getCause())
+    except BaseException, e:
+        warn("Sample failed: %s", e)
+        code = 1
+
+    # Skip the exit handlers of the parent, the stats have been dumped
+    _m5.core.doExitCleanup()
+    os._exit(code)
+
+def aggregate(samples):
+    """Compute the mean, standard deviation and 95% confidence
+    interval of every stat that all the samples have.
+
+    Returns a list of (name, mean, stdev, ci95, description) tuples
+    sorted by name.
+    """
+
+    samples = [ s for s in samples if s.stats ]
+    if not samples:
+        return []
+
+    names = set(samples[0].stats.keys())
+    for s in samples[1:]:
+        names &= set(s.stats.keys())
+
+    n = len(samples)
+    report = []
+    for name in sorted(names):
+        values = [ s.stats[name][0] for s in samples ]
+        mean = sum(values) / n
+        if n > 1:
+            var = sum((v - mean) ** 2 for v in values) / (n - 1)
+        else:
+            var = 0.0
+        stdev = math.sqrt(var)
+        ci95 = 1.96 * stdev / math.sqrt(n)
+        report.append((name, mean, stdev, ci95,
+                       samples[0].stats[name][1]))
+
+    return report
+
+def writeReport(filename, samples, report):
+    f = open(filename, "w")
+    done = [ s for s in samples if s.stats ]
+    print >>f, "# %d samples, %d failed" % (len(done),
+                                            len(samples) - len(done))
+    print >>f, "# %-38s %16s %16s %16s" % \
+        ("stat", "mean", "stdev", "ci95")
+    for name, mean, stdev, ci95, desc in report:
+        print >>f, "%-40s %16.6f %16.6f %16.6f  # %s" % \
+            (name, mean, stdev, ci95, desc)
+    f.close()
+
+def run(system, switch_cpu_list, period, warmup, length,
+        max_tick=None, jobs=0):
+    """Fast-forward to max_tick, sampling every period ticks.
+
+    Arguments:
+      system -- Simulated system.
+      switch_cpu_list -- (fast_cpu, detailed_cpu) tuples, the fast
+                         CPUs must be running.
+      period -- Ticks between sample points.
+      warmup -- Ticks of detailed simulation before measuring.
+      length -- Ticks of detailed simulation measured.
+
+    Keyword Arguments:
+      max_tick -- Tick to stop fast-forwarding at, the end of the
+                  workload by default.
+      jobs -- Maximum number of concurrent samples, 0 uses all the
+              host cores but the one of the parent.
+
+    Return Value:
+      The exit event that ended fast-forwarding, once all the samples
+      have completed and the report has been written.
+    """
+
+    if period <= 0 or length <= 0:
+        fatal("Sampling needs a positive period and length")
+
+    if not m5.listenersDisabled():
+        fatal("Sampling forks the simulator and needs listeners to be " \
+              "disabled, use m5.disableAllListeners() before instantiating")
+
+    from m5 import options
+
+    if max_tick is None:
+        max_tick = m5.MaxTick
+    if jobs <= 0:
+        jobs = max(_host_cores() - 1, 1)
+
+    samples = []
+    running = {}
+
+    # collect finished samples, waiting for one if block is set
+    def reap(block):
+        while running:
+            pid, status = os.waitpid(-1, 0 if block else os.WNOHANG)
+            if pid == 0:
+                return
+
+            sample = running.pop(pid, None)
+            if sample is None:
+                continue
+            if os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0:
+                sample.stats = readStats(os.path.join(sample.outdir,
+                                                      options.stats_file))
+            else:
+                warn("Sample %d @ tick %i failed", sample.index, sample.tick)
+
+            if block:
+                return
+
+    while True:
+        next_sample = m5.curTick() + period
+        if next_sample >= max_tick:
+            event = m5.simulate(max_tick - m5.curTick())
+            break
+
+        event = m5.simulate(period)
+        if event.getCause() != "simulate() limit reached":
+            break
+
+        reap(False)
+        while len(running) >= jobs:
+            reap(True)
+
+        index = len(samples)
+        outdir = os.path.join(options.outdir, sample_outdir % index)
+        pid = m5.fork(outdir)
+        if pid == 0:
+            _measure(system, switch_cpu_list, warmup, length)
+
+        samples.append(Sample(index, m5.curTick(), pid, outdir))
+        running[pid] = samples[-1]
+
+    while running:
+        reap(True)
+
+    report = aggregate(samples)
+    writeReport(os.path.join(options.outdir, report_name),
+                samples, report)
+    inform("Wrote the report of %d samples to %s", len(samples),
+           report_name)
+
+    return event
+
+__all__ = [ 'readStats', 'aggregate', 'writeReport', 'run' ]
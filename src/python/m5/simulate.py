@@ -49,6 +49,7 @@ import _m5.drain
 import _m5.core
 from _m5.stats import updateEvents as updateStatEvents
 
+import partition
 import stats
 import SimObject
 import ticks
@@ -86,6 +87,13 @@ def instantiate(ckpt_dir=None):
     # hierarchy so we catch them with future descendants() walks
     for obj in root.descendants(): obj.adoptOrphanParams()
 
+    # Apply the event queue partition stored with the checkpoint
+    # before the eventq_index proxies are resolved
+    if ckpt_dir and root.eventq_partition:
+        part = partition.read(ckpt_dir)
+        if part:
+            partition.apply(root, part)
+
     # Unproxy in sorted order for determinism
     for obj in root.descendants(): obj.unproxyParams()
 
@@ -159,7 +167,9 @@ def simulate(*args, **kwargs):
         need_startup = False
 
         # Python exit handlers happen in reverse order.
-        # We want to dump stats last.
+        # We want to dump stats last, and to wait for the dumps
+        # written in the background after that.
+        atexit.register(stats.flush)
         atexit.register(stats.dump)
 
         # register our C++ exit callback function with Python
@@ -225,6 +235,8 @@ def checkpoint(dir):
     memWriteback(root)
     print "Writing checkpoint"
     _m5.core.serializeAll(dir)
+    if partition.current:
+        partition.write(partition.current, dir)
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
@@ -345,6 +357,9 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 
     drain()
 
+    # the threads writing stats are not forked
+    stats.flush()
+
     try:
         pid = os.fork()
     except OSError, e:
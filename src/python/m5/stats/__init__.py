@@ -65,6 +65,15 @@ def _url_factory(func):
         wrapped_f(urlparse.urlsplit("text://stats.txt?desc=False")) ->
         f("stats.txt", desc=False)
 
+    The async parameter is handled for all the outputs. When it is
+    True, dumps are formatted and written on a background thread,
+    e.g., text://stats.txt?async=True.
+
+    So is the sparse parameter. When it is True, dumps leave out the
+    stats that are untouched since the last reset, and formulas using
+    only untouched stats are not evaluated, e.g.,
+    text://stats.txt?sparse=True.
+
     """
 
     from functools import wraps
@@ -93,12 +102,26 @@ def _url_factory(func):
                           % (url.geturl(), values[0]))
 
         kwargs = dict([ parse_value(k, v) for k, v in qs.items() ])
+        async_dump = kwargs.pop("async", False)
+        sparse = kwargs.pop("sparse", False)
 
         try:
-            return func("%s%s" % (url.netloc, url.path), **kwargs)
+            output = func("%s%s" % (url.netloc, url.path), **kwargs)
         except TypeError:
             fatal("Illegal stat visitor parameter specified")
 
+        if sparse and not output.canBeSparse():
+            fatal("%s: this output can't be sparse" % url.geturl())
+
+        # The wrapper of an async output is the one that skips the
+        # untouched stats, but set the flag on the wrapped output too
+        # so that it sees the same setting as a synchronous one.
+        output.sparse = sparse
+        if async_dump:
+            output = _m5.stats.initAsync(output)
+            output.sparse = sparse
+        return output
+
     return wrapper
 
 @_url_factory
@@ -115,11 +138,26 @@ def _textFactory(fn, desc=True):
 
     return _m5.stats.initText(fn, desc)
 
+@_url_factory
+def _binaryFactory(fn):
+    """Output stats in binary columnar format.
+
+    Binary stat files hold the names of the stats once and then a
+    record of packed values for every dump, which is much smaller and
+    faster to write than text. Read them with m5.stats.binary.
+
+    Example: binary://stats.bin
+
+    """
+
+    return _m5.stats.initBinary(fn)
+
 factories = {
     # Default to the text factory if we're given a naked path
     "" : _textFactory,
     "file" : _textFactory,
     "text" : _textFactory,
+    "binary" : _binaryFactory,
 }
 
 def addStatVisitor(url):
@@ -179,14 +217,15 @@ def enable():
         stats_dict[stat.name] = stat
         stat.enable()
 
+    _m5.stats.setDumpOrder(stats_list)
+
     _m5.stats.enable();
 
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
-        stat.prepare()
+    _m5.stats.prepareAll()
 
 lastDump = 0
 def dump():
@@ -206,10 +245,12 @@ def dump():
 
     for output in outputList:
         if output.valid():
-            output.begin()
-            for stat in stats_list:
-                stat.visit(output)
-            output.end()
+            _m5.stats.dumpTo(output)
+
+def flush():
+    '''Wait for the dumps written in the background to complete'''
+
+    _m5.stats.flushAsync()
 
 def reset():
     '''Reset all statistics to the base state'''
@@ -0,0 +1,129 @@
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Read stats written in binary columnar format (binary://).
+
+The format is described in src/base/stats/binary.hh. A file is read
+as a table with one row per dump and one column per stat value:
+
+    stats = StatsFile("m5out/stats.bin")
+    ipc = stats.column("system.cpu.ipc")
+    last = stats.dump(-1)
+
+Time-series written by a StatSampler use the same format, with one
+row per sample and the tick of the sample in the "tick" column. Files
+whose name ends in .gz are decompressed on the fly.
+
+This module does not depend on the simulator, and can be run as a
+script to print a dump in text format:
+
+    python src/python/m5/stats/binary.py m5out/stats.bin [dump]
+"""
+
+import array
+import struct
+import zlib
+from cStringIO import StringIO
+
+magic = "gem5stat"
+version = 1
+
+class StatsFile(object):
+    def __init__(self, filename):
+        with open(filename, "rb") as f:
+            data = f.read()
+        if filename.endswith(".gz"):
+            # decompress what is there, the end of the stream is missing
+            # if the simulation was interrupted
+            data = zlib.decompressobj(16 + zlib.MAX_WBITS).decompress(data)
+        f = StringIO(data)
+
+        if f.read(len(magic)) != magic:
+            raise ValueError("%s is not a binary stats file" % filename)
+        file_version, num_columns = struct.unpack("=II", f.read(8))
+        if file_version != version:
+            raise ValueError("%s has unsupported version %d" % \
+                             (filename, file_version))
+
+        def read_string():
+            length, = struct.unpack("=I", f.read(4))
+            return f.read(length)
+
+        self.names = []
+        self.descs = []
+        for i in xrange(num_columns):
+            self.names.append(read_string())
+            self.descs.append(read_string())
+        self.index = dict((name, i) for i, name in enumerate(self.names))
+
+        header = f.tell()
+        header += -header % 8
+
+        # ignore a partial record left by an interrupted simulation
+        record = 8 * num_columns
+        self.dumps = (len(data) - header) // record if record else 0
+
+        self.values = array.array("d")
+        self.values.fromstring(data[header:header + self.dumps * record])
+
+    def __len__(self):
+        return self.dumps
+
+    def __iter__(self):
+        for i in xrange(self.dumps):
+            yield self.dump(i)
+
+    def column(self, name):
+        """Values of a stat in every dump"""
+        n = len(self.names)
+        return self.values[self.index[name]::n].tolist()
+
+    def dump(self, i):
+        """Dictionary of the values of every stat in a dump"""
+        if i < 0:
+            i += self.dumps
+        if not 0 <= i < self.dumps:
+            raise IndexError("dump %d out of range" % i)
+        n = len(self.names)
+        return dict(zip(self.names, self.values[i * n:(i + 1) * n]))
+
+    def array(self):
+        """The whole file as a (dumps x columns) numpy array"""
+        import numpy
+        return numpy.frombuffer(self.values, dtype=numpy.float64) \
+                    .reshape(self.dumps, len(self.names))
+
+if __name__ == "__main__":
+    import sys
+
+    if len(sys.argv) not in (2, 3):
+        print >>sys.stderr, "Usage: %s <stats file> [dump]" % sys.argv[0]
+        sys.exit(1)
+
+    stats = StatsFile(sys.argv[1])
+    values = stats.dump(int(sys.argv[2]) if len(sys.argv) == 3 else -1)
+    for name, desc in zip(stats.names, stats.descs):
+        print "%-40s %12g # %s" % (name, values[name], desc)
@@ -48,9 +48,11 @@
 #include <map>
 #include <vector>
 
+#include "base/callback.hh"
 #include "base/debug.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
+#include "sim/core.hh"
 #include "sim/debug.hh"
 
 namespace py = pybind11;
@@ -71,11 +73,16 @@ output(const char *filename)
 }
 
 static void
-ignore(const char *expr)
+outputBinary(const char *filename, size_t ring_size)
 {
-    ObjectMatch ignore(expr);
-
-    Trace::getDebugLogger()->setIgnore(ignore);
+    OutputStream *file_stream = simout.findOrCreate(filename, true);
+    Trace::BinaryLogger *logger =
+        new Trace::BinaryLogger(*file_stream->stream(), ring_size);
+    Trace::setDebugLogger(logger);
+
+    // write out the records still buffered when the simulator exits
+    registerExitCallback(
+        new MakeCallback<Trace::Logger, &Trace::Logger::flush>(logger));
 }
 
 void
@@ -112,7 +119,9 @@ pybind_init_debug(py::module &m_native)
     py::module m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
-        .def("ignore", &ignore)
+        .def("output_binary", &outputBinary)
+        .def("select", &Trace::select)
+        .def("ignore", &Trace::ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
         ;
@@ -48,8 +48,10 @@
 
 #include "base/misc.hh"
 #include "sim/eventq.hh"
+#include "sim/eventq_partition.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
+#include "sim/sim_object.hh"
 #include "sim/simulate.hh"
 
 namespace py = pybind11;
@@ -115,6 +117,11 @@ pybind_init_event(py::module &m_native)
     m.def("getEventQueue", &getEventQueue,
           py::return_value_policy::reference);
 
+    m.def("startPartitionProfile", &EventqPartition::startProfile);
+    m.def("stopPartitionProfile", &EventqPartition::stopProfile);
+    m.def("partitionEvents", &EventqPartition::events);
+    m.def("partitionTraffic", &EventqPartition::traffic);
+
     py::class_<EventQueue>(m, "EventQueue")
         .def("name",  [](EventQueue *eq) { return eq->name(); })
         .def("dump", &EventQueue::dump)
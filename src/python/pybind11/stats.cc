@@ -45,6 +45,8 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/async.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "sim/stat_control.hh"
 #include "sim/stat_register.hh"
@@ -77,6 +79,11 @@ pybind_init_stats(py::module &m_native)
     m
         .def("initSimStats", &Stats::initSimStats)
         .def("initText", &Stats::initText, py::return_value_policy::reference)
+        .def("initBinary", &Stats::initBinary,
+             py::return_value_policy::reference)
+        .def("initAsync", &Stats::initAsync,
+             py::return_value_policy::reference)
+        .def("flushAsync", &Stats::flushAsync)
         .def("registerPythonStatsHandlers",
              &Stats::registerPythonStatsHandlers)
         .def("schedStatEvent", &Stats::schedStatEvent)
@@ -87,12 +94,19 @@ pybind_init_stats(py::module &m_native)
         .def("enable", &Stats::enable)
         .def("enabled", &Stats::enabled)
         .def("statsList", &Stats::statsList)
+        .def("setDumpOrder", [](const std::vector<Stats::Info *> &order) {
+                Stats::dumpOrder() = order;
+            })
+        .def("prepareAll", &Stats::prepareAll)
+        .def("dumpTo", &Stats::dumpTo)
         ;
 
     py::class_<Stats::Output>(m, "Output")
         .def("begin", &Stats::Output::begin)
         .def("end", &Stats::Output::end)
         .def("valid", &Stats::Output::valid)
+        .def("canBeSparse", &Stats::Output::canBeSparse)
+        .def_readwrite("sparse", &Stats::Output::sparse)
         ;
 
     py::class_<Stats::Info>(m, "Info")
@@ -108,6 +122,7 @@ pybind_init_stats(py::module &m_native)
         .def("prepare", &Stats::Info::prepare)
         .def("reset", &Stats::Info::reset)
         .def("zero", &Stats::Info::zero)
+        .def("untouched", &Stats::Info::untouched)
         .def("visit", &Stats::Info::visit)
         ;
 }
@@ -29,9 +29,12 @@
 # Authors: Nathan Binkert
 
 from m5.SimObject import SimObject
+from m5.defines import buildEnv
 from m5.params import *
 from m5.util import fatal
 
+class EventQueueBackend(Enum): vals = ['sorted_list', 'calendar']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -68,6 +71,46 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Adapt the quantum to the interaction between the event queues,
+    # starting at sim_quantum. The bounds default to sim_quantum.
+    sim_quantum_adaptive = Param.Bool(False, "adapt the simulation quantum")
+    sim_quantum_min = Param.Tick(0, "shortest adaptive quantum")
+    sim_quantum_max = Param.Tick(0, "longest adaptive quantum")
+    sim_quantum_interval = Param.Unsigned(16,
+        "number of quanta between quantum adjustments")
+    sim_quantum_wait_target = Param.Float(0.1,
+        "fraction of host time waiting at the barrier above which the "
+        "quantum grows")
+    sim_quantum_interaction_limit = Param.Float(1.0,
+        "cross-queue interactions per quantum above which the quantum "
+        "shrinks")
+
+    # Host time a thread spins at a quantum barrier before blocking in
+    # the kernel. Spinning pays off for short quanta when the threads
+    # arrive at the barrier close together.
+    sim_barrier_spin = Param.Clock("20us",
+        "host time to spin at a global barrier before blocking")
+
+    # Data structure used to keep the events of all main event queues
+    # sorted. Defaults to the USE_CALENDAR_EVENTQ build option.
+    eventq_backend = Param.EventQueueBackend(
+        'calendar' if buildEnv['USE_CALENDAR_EVENTQ'] else 'sorted_list',
+        "event queue implementation")
+
+    # Host time profiling of the serviced events, reported as stats
+    # and in eventq_profile.txt at exit.
+    eventq_profile = Param.Bool(False,
+        "profile host time per event type")
+    eventq_profile_by_name = Param.Bool(False,
+        "profile events by name rather than by description")
+    eventq_profile_entries = Param.Unsigned(32,
+        "number of event types reported in the profile stats")
+
+    # Apply the event queue partition computed by m5.partition and
+    # stored in a checkpoint when restoring from it.
+    eventq_partition = Param.Bool(True,
+        "apply the event queue partition stored in a checkpoint")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
@@ -39,6 +39,8 @@ from SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemoryCheckpointFormat(Enum): vals = ['gzip', 'raw']
+
 class System(MemObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -64,6 +66,29 @@ class System(MemObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Incremental checkpoints only store the memory pages that changed
+    # since the checkpoint the memory was last written to or restored
+    # from, and refer to that checkpoint as their parent. Restoring
+    # requires the whole chain of parents, util/cpt_flatten.py turns
+    # an incremental checkpoint into a self-contained one.
+    incremental_checkpoint = Param.Bool(False, "only checkpoint the " \
+                                            "memory pages that changed")
+
+    # Memory is checkpointed as a gzip compressed image by default. A
+    # raw image is larger on disk, although pages of zeros are left
+    # as holes in the file, but is restored by mapping it copy-on-write
+    # rather than by reading it, which takes constant time. The
+    # checkpoint must not be modified while a simulation restored from
+    # it is running.
+    checkpoint_memory_format = Param.MemoryCheckpointFormat('gzip',
+        "format of the memory images in checkpoints")
+
+    # gzip images are compressed in independent chunks on several host
+    # threads, and remain regular gzip files. Their index lets them be
+    # decompressed in parallel on restore.
+    checkpoint_compress_threads = Param.Unsigned(0, "host threads " \
+        "(de)compressing memory images, 0 uses all the host cores")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/adaptive_quantum.hh"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/misc.hh"
+#include "sim/eventq.hh"
+
+AdaptiveQuantum *adaptiveQuantum = NULL;
+
+static double
+hostTime()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AdaptiveQuantum::AdaptiveQuantum(Tick min_quantum, Tick max_quantum,
+                                 unsigned _interval, double wait_target,
+                                 double interaction_limit)
+    : _minQuantum(min_quantum), _maxQuantum(max_quantum),
+      interval(_interval), waitTarget(wait_target),
+      interactionLimit(interaction_limit), lastSync(0), quanta(0),
+      hostSeconds(0), waitSeconds(0)
+{
+    fatal_if(min_quantum == 0, "The minimum quantum must be non-zero\n");
+    fatal_if(min_quantum > max_quantum,
+             "The minimum quantum (%d) exceeds the maximum quantum (%d)\n",
+             min_quantum, max_quantum);
+    fatal_if(interval == 0, "The quantum adjustment interval must be "
+             "non-zero\n");
+}
+
+void
+AdaptiveQuantum::init()
+{
+    arrivals.assign(numMainEventQueues, 0);
+}
+
+void
+AdaptiveQuantum::regStats(const std::string &name)
+{
+    quantumTicks
+        .init(16)
+        .name(name + ".quantumTicks")
+        .desc("Length of the simulated quanta (ticks)")
+        ;
+
+    grows
+        .name(name + ".grows")
+        .desc("Number of times the quantum was lengthened")
+        ;
+
+    shrinks
+        .name(name + ".shrinks")
+        .desc("Number of times the quantum was shortened")
+        ;
+
+    interactions
+        .name(name + ".interactions")
+        .desc("Number of cross-queue schedules and migrations")
+        ;
+
+    barrierWait
+        .name(name + ".barrierWait")
+        .desc("Host time spent waiting at the quantum barrier by all "
+              "threads (s)")
+        ;
+}
+
+void
+AdaptiveQuantum::arrive()
+{
+    EventQueue *eventq = curEventQueue();
+    auto it = std::find(mainEventQueue.begin(), mainEventQueue.end(),
+                        eventq);
+    assert(it != mainEventQueue.end());
+    assert(arrivals.size() == numMainEventQueues);
+
+    arrivals[it - mainEventQueue.begin()] = hostTime();
+}
+
+Tick
+AdaptiveQuantum::update(Tick quantum)
+{
+    const double now = hostTime();
+
+    if (lastSync == 0) {
+        // This is the first quantum of the parallel simulation,
+        // discard whatever happened before it started.
+        for (auto eventq : mainEventQueue)
+            eventq->resetInteraction();
+        lastSync = now;
+        return quantum;
+    }
+
+    // The last thread to arrive is the one calling this method, so
+    // 'now' is when the barrier was satisfied.
+    double wait = 0;
+    for (auto arrival : arrivals)
+        wait += now - arrival;
+
+    quantumTicks.sample(quantum);
+    barrierWait += wait;
+
+    ++quanta;
+    hostSeconds += now - lastSync;
+    waitSeconds += wait;
+    lastSync = now;
+
+    if (quanta < interval)
+        return quantum;
+
+    Counter num_interactions = 0;
+    for (auto eventq : mainEventQueue) {
+        num_interactions += eventq->interaction();
+        eventq->resetInteraction();
+    }
+    interactions += num_interactions;
+
+    const double interaction_rate = double(num_interactions) / quanta;
+    const double wait_frac =
+        waitSeconds / (numMainEventQueues * std::max(hostSeconds, 1e-9));
+
+    Tick next = quantum;
+    if (interaction_rate > interactionLimit) {
+        next = std::max(_minQuantum, quantum / 2);
+    } else if (wait_frac > waitTarget) {
+        next = std::min(_maxQuantum, quantum * 2);
+    }
+
+    if (next < quantum)
+        ++shrinks;
+    else if (next > quantum)
+        ++grows;
+
+    quanta = 0;
+    hostSeconds = 0;
+    waitSeconds = 0;
+
+    // Events that need to be scheduled at least one quantum into the
+    // future (e.g., global stat dumps and exits) use simQuantum.
+    simQuantum = next;
+    return next;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Adaptive simulation quantum for multi-threaded simulation.
+ */
+
+#ifndef __SIM_ADAPTIVE_QUANTUM_HH__
+#define __SIM_ADAPTIVE_QUANTUM_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+/**
+ * Adapt the simulation quantum to the interaction between the event
+ * queues of a parallel simulation.
+ *
+ * A short quantum keeps the threads closely synchronized, but every
+ * synchronization costs a trip through the global barrier. A long
+ * quantum makes the barrier cheap, but delays the interaction between
+ * queues. The controller measures, over a number of quanta, the host
+ * time threads spend waiting for each other at the quantum barrier
+ * and the cross-queue interaction (events scheduled asynchronously
+ * from other queues and ScopedMigrations into a queue). The quantum
+ * is halved when the queues interact more often than a threshold
+ * and doubled when the barrier dominates host time, always staying
+ * within user-set bounds.
+ *
+ * Note that the maximum quantum must not exceed the minimum latency
+ * of any cross-queue communication in the simulated system, exactly
+ * like a fixed quantum.
+ */
+class AdaptiveQuantum
+{
+  public:
+    /**
+     * @param min_quantum Shortest quantum.
+     * @param max_quantum Longest quantum.
+     * @param interval Number of quanta between adjustments.
+     * @param wait_target Fraction of host time spent waiting at the
+     * barrier above which the quantum grows.
+     * @param interaction_limit Number of cross-queue interactions per
+     * quantum above which the quantum shrinks.
+     */
+    AdaptiveQuantum(Tick min_quantum, Tick max_quantum, unsigned interval,
+                    double wait_target, double interaction_limit);
+
+    /** Size the per-queue state once all queues have been created. */
+    void init();
+
+    void regStats(const std::string &name);
+
+    /**
+     * Record that the calling thread arrived at the quantum barrier.
+     * Must be called before waiting on the barrier.
+     */
+    void arrive();
+
+    /**
+     * Account for a completed quantum and pick the next one.
+     *
+     * This is called by the thread processing the global quantum
+     * event while all other threads wait at the barrier.
+     *
+     * @param quantum Length of the completed quantum.
+     * @return Length of the next quantum.
+     */
+    Tick update(Tick quantum);
+
+    Tick minQuantum() const { return _minQuantum; }
+    Tick maxQuantum() const { return _maxQuantum; }
+
+  private:
+    const Tick _minQuantum;
+    const Tick _maxQuantum;
+    const unsigned interval;
+    const double waitTarget;
+    const double interactionLimit;
+
+    /** Host time (s) each queue arrived at the barrier */
+    std::vector<double> arrivals;
+    /** Host time (s) the last quantum started, 0 before the first */
+    double lastSync;
+
+    /** @{ */
+    /** Measurements since the last adjustment */
+    unsigned quanta;
+    double hostSeconds;
+    double waitSeconds;
+    /** @} */
+
+    Stats::Histogram quantumTicks;
+    Stats::Scalar grows;
+    Stats::Scalar shrinks;
+    Stats::Scalar interactions;
+    Stats::Scalar barrierWait;
+};
+
+/**
+ * Controller adapting simQuantum, NULL unless the adaptive quantum
+ * is enabled.
+ */
+extern AdaptiveQuantum *adaptiveQuantum;
+
+#endif // __SIM_ADAPTIVE_QUANTUM_HH__
@@ -32,6 +32,7 @@ volatile bool async_event = false;
 volatile bool async_statdump = false;
 volatile bool async_statreset = false;
 volatile bool async_exit = false;
+volatile bool async_recorderdump = false;
 volatile bool async_io = false;
 volatile bool async_exception = false;
 
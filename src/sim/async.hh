@@ -45,6 +45,7 @@ extern volatile bool async_event;       ///< Some asynchronous event has happene
 extern volatile bool async_statdump;    ///< Async request to dump stats.
 extern volatile bool async_statreset;   ///< Async request to reset stats.
 extern volatile bool async_exit;        ///< Async request to exit simulator.
+extern volatile bool async_recorderdump; ///< Async flight recorder dump.
 extern volatile bool async_io;          ///< Async I/O request (SIGIO).
 extern volatile bool async_exception;   ///< Python exception.
 //@}
@@ -39,6 +39,7 @@
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "sim/eventq.hh"
+#include "sim/init_signals.hh"
 
 using namespace std;
 
@@ -131,3 +132,35 @@ doExitCleanup()
     cout.flush();
 }
 
+/**
+ * Queue of flight recorders to dump on request.
+ */
+inline CallbackQueue &
+flightRecorders()
+{
+    static CallbackQueue theQueue;
+    return theQueue;
+}
+
+void
+registerFlightRecorder(Callback *callback)
+{
+    if (flightRecorders().empty())
+        initFlightRecorderSignal();
+
+    flightRecorders().add(callback);
+}
+
+void
+dumpFlightRecorders()
+{
+    // a panic while dumping would otherwise come right back here
+    static bool dumping = false;
+    if (dumping)
+        return;
+
+    dumping = true;
+    flightRecorders().process();
+    dumping = false;
+}
+
@@ -97,6 +97,14 @@ void setOutputDir(const std::string &dir);
 
 class Callback;
 void registerExitCallback(Callback *callback);
+
+/**
+ * Register a flight recorder, i.e., a callback that prints the recent
+ * history it keeps. Flight recorders are dumped on a panic or fatal
+ * error, on SIGHUP and from the dumptrace m5 op.
+ */
+void registerFlightRecorder(Callback *callback);
+void dumpFlightRecorders();
 void doExitCleanup();
 
 #endif /* __SIM_CORE_HH__ */
@@ -32,6 +32,7 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -44,6 +45,7 @@
 #include "debug/Checkpoint.hh"
 #include "sim/core.hh"
 #include "sim/eventq_impl.hh"
+#include "sim/eventq_profiler.hh"
 
 using namespace std;
 
@@ -60,6 +62,13 @@ vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+const size_t EventQueue::minCalendarBuckets;
+const unsigned EventQueue::initialCalendarShift;
+const size_t EventQueue::calendarWidthSamples;
+
+EventQueue::Backend EventQueue::defaultBackend =
+    USE_CALENDAR_EVENTQ ? EventQueue::Calendar : EventQueue::SortedList;
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
@@ -114,19 +123,20 @@ Event::insertBefore(Event *event, Event *curr)
     return event;
 }
 
-void
-EventQueue::insert(Event *event)
+bool
+Event::insertSorted(Event *&first, Event *event)
 {
     // Deal with the head case
-    if (!head || *event <= *head) {
-        head = Event::insertBefore(event, head);
-        return;
+    if (!first || *event <= *first) {
+        const bool new_bin = !first || *event < *first;
+        first = Event::insertBefore(event, first);
+        return new_bin;
     }
 
     // Figure out either which 'in bin' list we are on, or where a new list
     // needs to be inserted
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = first;
+    Event *curr = first->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -134,7 +144,18 @@ EventQueue::insert(Event *event)
 
     // Note: this operation may render all nextBin pointers on the
     // prev 'in bin' list stale (except for the top one)
+    const bool new_bin = !curr || *event < *curr;
     prev->nextBin = Event::insertBefore(event, curr);
+    return new_bin;
+}
+
+void
+EventQueue::insert(Event *event)
+{
+    if (_backend == Calendar)
+        calendarInsert(event);
+    else
+        Event::insertSorted(head, event);
 }
 
 Event *
@@ -168,24 +189,23 @@ Event::removeItem(Event *event, Event *top)
     return top;
 }
 
-void
-EventQueue::remove(Event *event)
+bool
+Event::removeSorted(Event *&first, Event *event)
 {
-    if (head == NULL)
+    if (first == NULL)
         panic("event not found!");
 
-    assert(event->queue == this);
-
-    // deal with an event on the head's 'in bin' list (event has the same
-    // time as the head)
-    if (*head == *event) {
-        head = Event::removeItem(event, head);
-        return;
+    // deal with an event on the first 'in bin' list (event has the same
+    // time as the first bin)
+    if (*first == *event) {
+        const bool last_in_bin = event == first && !event->nextInBin;
+        first = Event::removeItem(event, first);
+        return last_in_bin;
     }
 
     // Find the 'in bin' list that this event belongs on
-    Event *prev = head;
-    Event *curr = head->nextBin;
+    Event *prev = first;
+    Event *curr = first->nextBin;
     while (curr && *curr < *event) {
         prev = curr;
         curr = curr->nextBin;
@@ -197,7 +217,20 @@ EventQueue::remove(Event *event)
     // curr points to the top item of the the correct 'in bin' list, when
     // we remove an item, it returns the new top item (which may be
     // unchanged)
+    const bool last_in_bin = event == curr && !event->nextInBin;
     prev->nextBin = Event::removeItem(event, curr);
+    return last_in_bin;
+}
+
+void
+EventQueue::remove(Event *event)
+{
+    assert(event->queue == this);
+
+    if (_backend == Calendar)
+        calendarRemove(event);
+    else
+        Event::removeSorted(head, event);
 }
 
 Event *
@@ -208,7 +241,9 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (_backend == Calendar) {
+        calendarPopHead();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -225,7 +260,10 @@ EventQueue::serviceOne()
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
 
-        event->process();
+        if (_profiler)
+            _profiler->process(event);
+        else
+            event->process();
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -300,15 +338,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : sortedBins()) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -323,8 +358,7 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : sortedBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -350,8 +384,18 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
+    }
 
-        nextBin = nextBin->nextBin;
+    if (_backend == Calendar) {
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            for (Event *bin = buckets[i]; bin; bin = bin->nextBin) {
+                if (bucketIndex(bin->when()) != i) {
+                    cprintf("bin in wrong bucket!");
+                    bin->dump();
+                    return false;
+                }
+            }
+        }
     }
 
     return true;
@@ -360,11 +404,229 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    if (_backend != Calendar) {
+        Event* t = head;
+        head = s;
+        return t;
+    }
+
+    Event *t = calendarFlatten();
+    while (s) {
+        Event *next_bin = s->nextBin;
+        calendarInsertBin(s);
+        s = next_bin;
+    }
     return t;
 }
 
+void
+EventQueue::backend(Backend b)
+{
+    if (b == _backend)
+        return;
+
+    Event *pending = replaceHead(NULL);
+    _backend = b;
+    if (_backend == Calendar) {
+        buckets.assign(minCalendarBuckets, NULL);
+        bucketMask = minCalendarBuckets - 1;
+        bucketShift = initialCalendarShift;
+        numBins = 0;
+    } else {
+        buckets.clear();
+        buckets.shrink_to_fit();
+    }
+    replaceHead(pending);
+}
+
+std::vector<Event *>
+EventQueue::sortedBins() const
+{
+    std::vector<Event *> bins;
+    if (_backend != Calendar) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return bins;
+    }
+
+    for (Event *first : buckets) {
+        for (Event *bin = first; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+    std::sort(bins.begin(), bins.end(),
+              [](const Event *l, const Event *r) { return *l < *r; });
+    return bins;
+}
+
+void
+EventQueue::calendarInsert(Event *event)
+{
+    Event *&first = buckets[bucketIndex(event->when())];
+    const bool new_bin = Event::insertSorted(first, event);
+
+    // An event that isn't later than the head ends up in the
+    // earliest bin, which has to be the first bin of its bucket.
+    if (!head || *event <= *head)
+        head = first;
+
+    if (new_bin && ++numBins > 2 * buckets.size())
+        calendarResize(2 * buckets.size());
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    if (head == NULL)
+        panic("event not found!");
+
+    Event *&first = buckets[bucketIndex(event->when())];
+    const bool head_bin = *event == *head;
+    const bool bin_removed = Event::removeSorted(first, event);
+
+    if (head_bin)
+        head = bin_removed ? calendarFindHead(event->when()) : first;
+
+    if (bin_removed) {
+        --numBins;
+        if (numBins < buckets.size() / 2 &&
+            buckets.size() > minCalendarBuckets) {
+            calendarResize(buckets.size() / 2);
+        }
+    }
+}
+
+void
+EventQueue::calendarPopHead()
+{
+    Event *event = head;
+    Event *&first = buckets[bucketIndex(event->when())];
+    assert(first == event);
+
+    if (Event *next = event->nextInBin) {
+        // update the next bin pointer since it could be stale
+        next->nextBin = event->nextBin;
+        head = first = next;
+        return;
+    }
+
+    // this was the last event in the bin, move on to the next bin
+    first = event->nextBin;
+    head = calendarFindHead(event->when());
+
+    --numBins;
+    if (numBins < buckets.size() / 2 && buckets.size() > minCalendarBuckets)
+        calendarResize(buckets.size() / 2);
+}
+
+Event *
+EventQueue::calendarFindHead(Tick after) const
+{
+    // Scan one 'year' of buckets starting at the bucket containing
+    // 'after'. Since no bin is earlier than 'after' and every bucket
+    // is sorted, the first bin that falls into the part of the year
+    // covered by its bucket is the earliest one.
+    const Tick day = after >> bucketShift;
+    const Tick last_day = MaxTick >> bucketShift;
+    for (size_t i = 0; i < buckets.size() && day + i < last_day; ++i) {
+        Event *first = buckets[(day + i) & bucketMask];
+        if (first && (first->when() >> bucketShift) == day + i)
+            return first;
+    }
+
+    // The bins are sparse compared to the length of a year, fall back
+    // to a direct search of the earliest bin.
+    Event *earliest = NULL;
+    for (Event *first : buckets) {
+        if (first && (!earliest || *first < *earliest))
+            earliest = first;
+    }
+    return earliest;
+}
+
+void
+EventQueue::calendarInsertBin(Event *top)
+{
+    Event *&first = buckets[bucketIndex(top->when())];
+    if (!first || *top < *first) {
+        top->nextBin = first;
+        first = top;
+    } else {
+        Event *prev = first;
+        while (prev->nextBin && *prev->nextBin < *top)
+            prev = prev->nextBin;
+        assert(!prev->nextBin || *prev->nextBin != *top);
+        top->nextBin = prev->nextBin;
+        prev->nextBin = top;
+    }
+
+    if (!head || *top < *head)
+        head = top;
+
+    if (++numBins > 2 * buckets.size())
+        calendarResize(2 * buckets.size());
+}
+
+void
+EventQueue::calendarResize(size_t size)
+{
+    std::vector<Event *> bins(sortedBins());
+
+    // Pick a bucket width of roughly three times the average distance
+    // between the bins at the head of the queue, which is where
+    // events will be scheduled and serviced in the near future. Gaps
+    // that are much larger than the average are ignored since they
+    // would skew the width towards long and sparse buckets.
+    const size_t samples = std::min<size_t>(bins.size(),
+                                            calendarWidthSamples);
+    if (samples > 1) {
+        const Tick span = bins[samples - 1]->when() - bins[0]->when();
+        const Tick avg_gap = span / (samples - 1);
+        Tick gaps = 0;
+        unsigned num_gaps = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            const Tick gap = bins[i]->when() - bins[i - 1]->when();
+            if (gap <= 2 * avg_gap) {
+                gaps += gap;
+                ++num_gaps;
+            }
+        }
+
+        if (gaps > 0) {
+            const Tick width = 3 * gaps / num_gaps;
+            bucketShift = 0;
+            while ((Tick(1) << (bucketShift + 1)) <= width)
+                ++bucketShift;
+        }
+    }
+
+    buckets.assign(size, NULL);
+    bucketMask = size - 1;
+
+    // Insert the bins in reverse order so every bin ends up at the
+    // front of its bucket.
+    for (auto bin = bins.rbegin(); bin != bins.rend(); ++bin) {
+        Event *&first = buckets[bucketIndex((*bin)->when())];
+        (*bin)->nextBin = first;
+        first = *bin;
+    }
+}
+
+Event *
+EventQueue::calendarFlatten()
+{
+    std::vector<Event *> bins(sortedBins());
+    for (size_t i = 0; i + 1 < bins.size(); ++i)
+        bins[i]->nextBin = bins[i + 1];
+    if (!bins.empty())
+        bins.back()->nextBin = NULL;
+
+    std::fill(buckets.begin(), buckets.end(), (Event *)NULL);
+    numBins = 0;
+    head = NULL;
+
+    return bins.empty() ? NULL : bins.front();
+}
+
 void
 dumpMainQueue()
 {
@@ -413,16 +675,133 @@ Event::dump() const
     }
 }
 
+__thread EventPool *EventPool::_local = NULL;
+
+namespace {
+
+std::mutex eventPoolsMutex;
+std::vector<EventPool *> eventPools;
+
+}
+
+const size_t EventPool::blockAlign;
+const size_t EventPool::maxBlockSize;
+const size_t EventPool::slabSize;
+
+EventPool::EventPool()
+    : slabPtr(NULL), slabLeft(0), allocs(0), heapAllocs(0)
+{
+    std::fill(std::begin(freeLists), std::end(freeLists),
+              (FreeBlock *)NULL);
+}
+
+EventPool *
+EventPool::create()
+{
+    // Pools are never destroyed since events allocated by one thread
+    // may be recycled by the pool of another.
+    EventPool *pool = new EventPool();
+    std::lock_guard<std::mutex> lock(eventPoolsMutex);
+    eventPools.push_back(pool);
+    return pool;
+}
+
+void *
+EventPool::allocateFromSlab(size_t size)
+{
+    const size_t block_size = (sizeClass(size) + 1) * blockAlign;
+    if (slabLeft < block_size) {
+        // Whatever is left of the current slab is too small for this
+        // block, leave it unused.
+        ++heapAllocs;
+        slabPtr = new uint8_t[slabSize];
+        slabLeft = slabSize;
+    }
+
+    void *block = slabPtr;
+    slabPtr += block_size;
+    slabLeft -= block_size;
+    return block;
+}
+
+Counter
+EventPool::totalAllocs()
+{
+    std::lock_guard<std::mutex> lock(eventPoolsMutex);
+    Counter total = 0;
+    for (auto pool : eventPools)
+        total += pool->allocs;
+    return total;
+}
+
+Counter
+EventPool::totalHeapAllocs()
+{
+    std::lock_guard<std::mutex> lock(eventPoolsMutex);
+    Counter total = 0;
+    for (auto pool : eventPools)
+        total += pool->heapAllocs;
+    return total;
+}
+
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), _backend(SortedList),
+      bucketShift(initialCalendarShift), bucketMask(0), numBins(0),
+      _profiler(NULL), _hostLoopListener(NULL), asyncInserts(0),
+      migrations(0), inHostLoop(false), hostLoopSeconds(0),
+      hostBarrierSeconds(0)
+{
+    backend(defaultBackend);
+}
+
+void
+EventQueue::enterHostLoop()
+{
+    hostLoopStart = std::chrono::steady_clock::now();
+    inHostLoop = true;
+
+    if (_hostLoopListener)
+        _hostLoopListener->enterHostLoop();
+}
+
+void
+EventQueue::exitHostLoop()
 {
+    if (_hostLoopListener)
+        _hostLoopListener->exitHostLoop();
+
+    hostLoopSeconds += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - hostLoopStart).count();
+    inHostLoop = false;
+}
+
+void
+EventQueue::takeHostTimes(double &run_seconds, double &barrier_seconds)
+{
+    // Stats are usually dumped from within the simulation loop, fold
+    // in the time of the current visit. This may be called by another
+    // thread, so don't tell the listener.
+    if (inHostLoop) {
+        const auto now = std::chrono::steady_clock::now();
+        hostLoopSeconds +=
+            std::chrono::duration<double>(now - hostLoopStart).count();
+        hostLoopStart = now;
+    }
+
+    run_seconds = std::max(hostLoopSeconds - hostBarrierSeconds, 0.0);
+    barrier_seconds = hostBarrierSeconds;
+    hostLoopSeconds = hostBarrierSeconds = 0;
 }
 
 void
-EventQueue::asyncInsert(Event *event)
+EventQueue::asyncInsert(Event *event, bool global)
 {
     async_queue_mutex.lock();
     async_queue.push_back(event);
+    // Global events are always inserted asynchronously to keep them
+    // totally ordered, they don't count as an interaction.
+    if (!global)
+        ++asyncInserts;
     async_queue_mutex.unlock();
 }
 
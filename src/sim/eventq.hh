@@ -40,18 +40,26 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <climits>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/types.hh"
+#include "config/use_calendar_eventq.hh"
 #include "debug/Event.hh"
+#include "sim/eventq_partition.hh"
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
+class EventProfiler;
 class BaseGlobalEvent;
 
 //! Simulation Quantum for multiple eventq simulation.
@@ -202,6 +210,18 @@ class Event : public EventBase, public Serializable
     static Event *insertBefore(Event *event, Event *curr);
     static Event *removeItem(Event *event, Event *last);
 
+    /**
+     * @{
+     * Insert / remove an event in a sorted list of bins starting at
+     * 'first', which is updated if the first bin changes.
+     *
+     * @return true if a bin was created (insertion) or emptied and
+     * removed (removal).
+     */
+    static bool insertSorted(Event *&first, Event *event);
+    static bool removeSorted(Event *&first, Event *event);
+    /** @} */
+
     Tick _when;         //!< timestamp when event should be processed
     Priority _priority; //!< event priority
     Flags flags;
@@ -447,6 +467,182 @@ operator!=(const Event &l, const Event &r)
     return l.when() != r.when() || l.priority() != r.priority();
 }
 
+/**
+ * Allocator for short-lived events.
+ *
+ * Every simulation thread has its own pool, which serves events from
+ * per-size free lists that are refilled from large slabs. Storage is
+ * never returned to the host heap; freed events are recycled by the
+ * pool of the thread that releases them. Since each main event queue
+ * is serviced by a single thread, this is effectively a per-queue
+ * pool that doesn't need any locking.
+ *
+ * Events use the pool by deriving from PooledEvent. Callbacks that
+ * only need to run once can use newOneShotEvent() or
+ * EventManager::scheduleOneShot() instead.
+ */
+class EventPool
+{
+  public:
+    /** Get the pool of the calling thread. */
+    static EventPool &
+    local()
+    {
+        if (!_local)
+            _local = create();
+        return *_local;
+    }
+
+    void *
+    allocate(size_t size)
+    {
+        ++allocs;
+        if (size > maxBlockSize) {
+            ++heapAllocs;
+            return ::operator new(size);
+        }
+
+        FreeBlock *&free_list = freeLists[sizeClass(size)];
+        if (FreeBlock *block = free_list) {
+            free_list = block->next;
+            return block;
+        }
+
+        return allocateFromSlab(size);
+    }
+
+    void
+    deallocate(void *p, size_t size)
+    {
+        if (size > maxBlockSize) {
+            ::operator delete(p);
+            return;
+        }
+
+        FreeBlock *&free_list = freeLists[sizeClass(size)];
+        FreeBlock *block = static_cast<FreeBlock *>(p);
+        block->next = free_list;
+        free_list = block;
+    }
+
+    /** @{ */
+    /** Number of allocations served by all pools. */
+    static Counter totalAllocs();
+    /** Number of allocations that had to use the host heap. */
+    static Counter totalHeapAllocs();
+    /** @} */
+
+  private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /** Allocation granularity, must be a power of two. */
+    static const size_t blockAlign = 16;
+    /** Larger events are allocated on the host heap. */
+    static const size_t maxBlockSize = 256;
+    /** Size of the slabs free lists are refilled from. */
+    static const size_t slabSize = 64 * 1024;
+
+    static size_t sizeClass(size_t size) { return (size - 1) / blockAlign; }
+
+    EventPool();
+
+    void *allocateFromSlab(size_t size);
+
+    FreeBlock *freeLists[maxBlockSize / blockAlign];
+    uint8_t *slabPtr;
+    size_t slabLeft;
+
+    Counter allocs;
+    Counter heapAllocs;
+
+    /** Create the pool of the calling thread. */
+    static EventPool *create();
+
+    static __thread EventPool *_local;
+};
+
+/**
+ * Base class for events that are allocated from the EventPool of the
+ * calling thread rather than from the host heap. This is intended for
+ * events that are allocated and freed (typically with the AutoDelete
+ * flag set) every time they happen.
+ */
+class PooledEvent : public Event
+{
+  public:
+    PooledEvent(Priority p = Default_Pri, Flags f = 0)
+        : Event(p, f)
+    {}
+
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::local().allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::local().deallocate(p, size);
+    }
+};
+
+/**
+ * Pooled event that calls a function once and deletes itself. The
+ * function is stored in the event itself, so, unlike
+ * EventFunctionWrapper, this needs no host heap allocations.
+ *
+ * @see newOneShotEvent()
+ */
+template <typename F>
+class OneShotEvent : public PooledEvent
+{
+  private:
+    F callback;
+    const char *_name;
+
+  public:
+    OneShotEvent(F &&_callback, const char *name, Priority p)
+        : PooledEvent(p, AutoDelete), callback(std::move(_callback)),
+          _name(name)
+    {}
+
+    OneShotEvent(const F &_callback, const char *name, Priority p)
+        : PooledEvent(p, AutoDelete), callback(_callback), _name(name)
+    {}
+
+    void process() { callback(); }
+
+    const std::string
+    name() const
+    {
+        return std::string(_name) + ".one_shot_event";
+    }
+
+    const char *description() const { return "OneShot"; }
+};
+
+/**
+ * Allocate an event that calls 'callback' when it is processed and is
+ * deleted afterwards (or when descheduled).
+ *
+ * @param callback Function to call.
+ * @param name Name of the event, this must be a string that outlives
+ * the event (e.g., a string literal).
+ * @param p Event priority.
+ */
+template <typename F>
+Event *
+newOneShotEvent(F &&callback, const char *name,
+                Event::Priority p = Event::Default_Pri)
+{
+    return new OneShotEvent<typename std::decay<F>::type>(
+        std::forward<F>(callback), name, p);
+}
+
 /**
  * Queue of events sorted in time order
  *
@@ -487,17 +683,137 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structure used to keep the pending events sorted.
+     *
+     * Both backends store events in bins of events with the same time
+     * and priority (see Event::nextBin and Event::nextInBin), so the
+     * service order, including the LIFO order of events within a
+     * bin, is identical. They only differ in how the bins are kept
+     * sorted:
+     *
+     * SortedList keeps all bins in a single sorted list. Insertion
+     * and removal are linear in the number of pending bins.
+     *
+     * Calendar keeps the bins in a calendar queue (R. Brown, CACM
+     * 1988). Bins are hashed into an array of buckets that each
+     * cover a power-of-two number of ticks. Every bucket holds a
+     * short sorted list, which makes insertion and removal constant
+     * time on average. The number of buckets and their width adapt
+     * to the number of pending bins and their spacing in time.
+     */
+    enum Backend {
+        SortedList,
+        Calendar,
+    };
+
+    //! Backend used by newly created event queues.
+    static Backend defaultBackend;
+
+    /**
+     * Interface of objects that follow the thread servicing a queue
+     * into and out of the simulation loop, e.g., to only measure the
+     * host while it simulates. Both calls are made by that thread.
+     */
+    class HostLoopListener
+    {
+      public:
+        virtual ~HostLoopListener() {}
+        virtual void enterHostLoop() = 0;
+        virtual void exitHostLoop() = 0;
+    };
+
   private:
     std::string objName;
     Event *head;
     Tick _curTick;
 
+    //! Data structure used to sort the pending events.
+    Backend _backend;
+
+    /**
+     * @{
+     * Calendar queue state, only used by the Calendar backend.
+     *
+     * Every entry in the bucket array points to the first bin of a
+     * sorted list of bins linked through their nextBin pointer. The
+     * 'head' pointer always points to the earliest bin, which
+     * therefore is the first bin of its bucket.
+     */
+    std::vector<Event *> buckets;
+    //! Smallest number of buckets, the calendar never shrinks below it
+    static const size_t minCalendarBuckets = 16;
+    //! Bucket width (log2 ticks) before the first resize
+    static const unsigned initialCalendarShift = 10;
+    //! Number of bins sampled to pick the bucket width on a resize
+    static const size_t calendarWidthSamples = 25;
+    //! log2 of the number of ticks covered by a bucket
+    unsigned bucketShift;
+    //! Number of buckets minus one (the bucket count is a power of two)
+    size_t bucketMask;
+    //! Number of pending bins in the calendar
+    size_t numBins;
+
+    size_t bucketIndex(Tick when) const
+    {
+        return (when >> bucketShift) & bucketMask;
+    }
+
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+    //! Remove the top event of the head bin from the calendar.
+    void calendarPopHead();
+    //! Find the earliest bin, none of which is earlier than 'after'.
+    Event *calendarFindHead(Tick after) const;
+    //! Insert a complete bin without touching its 'in bin' list.
+    void calendarInsertBin(Event *top);
+    //! Rehash all bins into 'size' buckets with a new bucket width.
+    void calendarResize(size_t size);
+    //! Remove all bins from the calendar and return them as a list.
+    Event *calendarFlatten();
+    /** @} */
+
+    //! Return the top events of all bins in service order.
+    std::vector<Event *> sortedBins() const;
+
+    //! Host time profiler, NULL unless profiling is enabled.
+    EventProfiler *_profiler;
+
+    //! Notified when the simulation loop is entered and left, or NULL.
+    HostLoopListener *_hostLoopListener;
+
     //! Mutex to protect async queue.
     std::mutex async_queue_mutex;
 
     //! List of events added by other threads to this event queue.
     std::list<Event*> async_queue;
 
+    /**
+     * @{
+     * Interaction with other queues since the last call to
+     * resetInteraction(). Both counters are updated while holding a
+     * lock (async_queue_mutex and the service lock respectively), but
+     * should only be read while all threads are synchronized.
+     */
+    //! Events scheduled on this queue by other threads
+    Counter asyncInserts;
+    //! Migrations of other threads into this queue
+    Counter migrations;
+    /** @} */
+
+    /**
+     * @{
+     * Host time of the thread servicing this queue since the last
+     * call to takeHostTimes(), spent in the simulation loop and, as
+     * part of it, waiting at global barriers.
+     */
+    std::chrono::steady_clock::time_point hostLoopStart;
+    bool inHostLoop;
+    double hostLoopSeconds;
+    double hostBarrierSeconds;
+    /** @} */
+
     /**
      * Lock protecting event handling.
      *
@@ -528,7 +844,7 @@ class EventQueue
     //! Function for adding events to the async queue. The added events
     //! are added to main event queue later. Threads, other than the
     //! owning thread, should call this function instead of insert().
-    void asyncInsert(Event *event);
+    void asyncInsert(Event *event, bool global);
 
     EventQueue(const EventQueue &);
 
@@ -551,6 +867,7 @@ class EventQueue
         {
             old_eq.unlock();
             new_eq.lock();
+            ++new_eq.migrations;
             curEventQueue(&new_eq);
         }
 
@@ -610,6 +927,34 @@ class EventQueue
     //! the owning thread.
     void reschedule(Event *event, Tick when, bool always = false);
 
+    //! Backend used to sort the pending events of this queue.
+    Backend backend() const { return _backend; }
+
+    /**
+     * Switch this queue to a different backend.
+     *
+     * Pending events are moved to the new backend without changing
+     * their service order, so this may be done at any time from the
+     * thread owning the queue.
+     */
+    void backend(Backend b);
+
+    /**
+     * Attach a host time profiler to this queue.
+     *
+     * @param profiler Profiler to account serviced events to, or NULL
+     * to disable profiling. The queue doesn't take ownership.
+     */
+    void profiler(EventProfiler *profiler) { _profiler = profiler; }
+    EventProfiler *profiler() const { return _profiler; }
+
+    /**
+     * Attach a listener to the simulation loop of this queue. The
+     * queue doesn't take ownership. Must not be changed while the
+     * queue is being serviced.
+     */
+    void hostLoopListener(HostLoopListener *l) { _hostLoopListener = l; }
+
     Tick nextTick() const { return head->when(); }
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() const { return _curTick; }
@@ -648,6 +993,32 @@ class EventQueue
     //! Function for moving events from the async_queue to the main queue.
     void handleAsyncInsertions();
 
+    /**
+     * Number of events scheduled on this queue by other threads and
+     * of migrations into this queue since the last reset. Should only
+     * be called while all threads are synchronized.
+     */
+    Counter interaction() const { return asyncInserts + migrations; }
+    void resetInteraction() { asyncInserts = migrations = 0; }
+
+    /**
+     * @{
+     * Account the host time of the thread servicing this queue. The
+     * simulation loop is entered and left by that thread, which also
+     * adds the time it waited at global barriers.
+     */
+    void enterHostLoop();
+    void exitHostLoop();
+    void addHostBarrierTime(double seconds) { hostBarrierSeconds += seconds; }
+    /** @} */
+
+    /**
+     * Get and clear the host time spent servicing events and waiting
+     * at global barriers since the last call. Should only be called
+     * while all threads are synchronized.
+     */
+    void takeHostTimes(double &run_seconds, double &barrier_seconds);
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -724,9 +1095,21 @@ class EventManager
         return eventq;
     }
 
+  private:
+    /** Count an event against this manager when profiling the load. */
+    void
+    profileEvent() const
+    {
+        if (EventqPartition::profiling)
+            EventqPartition::recordEvent(this);
+    }
+
+  public:
+
     void
     schedule(Event &event, Tick when)
     {
+        profileEvent();
         eventq->schedule(&event, when);
     }
 
@@ -739,12 +1122,14 @@ class EventManager
     void
     reschedule(Event &event, Tick when, bool always = false)
     {
+        profileEvent();
         eventq->reschedule(&event, when, always);
     }
 
     void
     schedule(Event *event, Tick when)
     {
+        profileEvent();
         eventq->schedule(event, when);
     }
 
@@ -757,9 +1142,28 @@ class EventManager
     void
     reschedule(Event *event, Tick when, bool always = false)
     {
+        profileEvent();
         eventq->reschedule(event, when, always);
     }
 
+    /**
+     * Schedule a pooled event that calls 'callback' once at 'when'.
+     *
+     * @see newOneShotEvent()
+     * @return The scheduled event, which is only valid until it has
+     * been processed or descheduled.
+     */
+    template <typename F>
+    Event *
+    scheduleOneShot(F &&callback, const char *name, Tick when,
+                    Event::Priority p = Event::Default_Pri)
+    {
+        Event *event = newOneShotEvent(std::forward<F>(callback), name, p);
+        profileEvent();
+        eventq->schedule(event, when);
+        return event;
+    }
+
     void wakeupEventQueue(Tick when = (Tick)-1)
     {
         eventq->wakeup(when);
@@ -54,7 +54,7 @@ EventQueue::schedule(Event *event, Tick when, bool global)
     //    a total order amongst the global events. See global_event.{cc,hh}
     //    for more explanation.
     if (inParallelMode && (this != curEventQueue() || global)) {
-        asyncInsert(event);
+        asyncInsert(event, global);
     } else {
         insert(event);
     }
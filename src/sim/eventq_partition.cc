@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/eventq_partition.hh"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "sim/sim_object.hh"
+
+namespace EventqPartition {
+
+bool profiling = false;
+
+namespace {
+
+/** The profile recorded by a single thread. */
+struct Profile
+{
+    typedef std::pair<const SimObject *, const SimObject *> Pair;
+
+    std::unordered_map<const EventManager *, Counter> events;
+    std::map<Pair, Counter> traffic;
+
+    void
+    clear()
+    {
+        events.clear();
+        traffic.clear();
+    }
+};
+
+std::mutex profilesMutex;
+std::vector<std::unique_ptr<Profile>> profiles;
+
+__thread Profile *localProfile = nullptr;
+
+Profile &
+local()
+{
+    if (!localProfile) {
+        std::lock_guard<std::mutex> lock(profilesMutex);
+        profiles.emplace_back(new Profile);
+        localProfile = profiles.back().get();
+    }
+    return *localProfile;
+}
+
+} // anonymous namespace
+
+void
+startProfile()
+{
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    for (auto &p : profiles)
+        p->clear();
+    profiling = true;
+}
+
+void
+stopProfile()
+{
+    profiling = false;
+}
+
+void
+recordEvent(const EventManager *em)
+{
+    ++local().events[em];
+}
+
+void
+recordTraffic(const SimObject *a, const SimObject *b)
+{
+    // Communication is counted in both directions alike
+    if (b < a)
+        std::swap(a, b);
+    ++local().traffic[Profile::Pair(a, b)];
+}
+
+Counter
+events(const SimObject *obj)
+{
+    const EventManager *em = obj;
+    Counter count = 0;
+
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    for (const auto &p : profiles) {
+        auto it = p->events.find(em);
+        if (it != p->events.end())
+            count += it->second;
+    }
+    return count;
+}
+
+std::vector<Link>
+traffic()
+{
+    std::map<Profile::Pair, Counter> merged;
+    {
+        std::lock_guard<std::mutex> lock(profilesMutex);
+        for (const auto &p : profiles) {
+            for (const auto &t : p->traffic)
+                merged[t.first] += t.second;
+        }
+    }
+
+    std::vector<Link> links;
+    links.reserve(merged.size());
+    for (const auto &t : merged) {
+        links.emplace_back(t.first.first->name(), t.first.second->name(),
+                           t.second);
+    }
+    return links;
+}
+
+} // namespace EventqPartition
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Profiling of the SimObject load used to partition a simulated
+ * system over the main event queues.
+ */
+
+#ifndef __SIM_EVENTQ_PARTITION_HH__
+#define __SIM_EVENTQ_PARTITION_HH__
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/types.hh"
+
+class EventManager;
+class SimObject;
+
+/**
+ * While a profile is being recorded, every event scheduled through an
+ * EventManager is counted against that manager, and every request and
+ * response sent through a port is counted against the pair of objects
+ * owning the two ends of the connection. The partitioner in
+ * m5.partition uses the event counts as the load of each SimObject
+ * and the packet counts as the coupling between them.
+ *
+ * Each thread records into its own tables, so a profile may be taken
+ * while running with multiple event queues. The tables are only
+ * merged when read, which must happen while the simulation is not
+ * running.
+ */
+namespace EventqPartition {
+
+/** Set while a profile is being recorded. */
+extern bool profiling;
+
+/** Clear any previous profile and start recording a new one. */
+void startProfile();
+
+/** Stop recording, the profile can be read afterwards. */
+void stopProfile();
+
+/** Count an event scheduled through an event manager. */
+void recordEvent(const EventManager *em);
+
+/** Count a packet sent between the two objects. */
+void recordTraffic(const SimObject *a, const SimObject *b);
+
+/** Number of events scheduled through an object in the profile. */
+Counter events(const SimObject *obj);
+
+/** Name of two communicating objects and their packet count. */
+typedef std::tuple<std::string, std::string, Counter> Link;
+
+/** All object pairs that communicated in the profile. */
+std::vector<Link> traffic();
+
+} // namespace EventqPartition
+
+#endif // __SIM_EVENTQ_PARTITION_HH__
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/eventq_profiler.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <ostream>
+
+#include "base/cprintf.hh"
+
+EventProfiler::EventProfiler(bool by_name, unsigned max_entries)
+    : byName(by_name), maxEntries(max_entries)
+{
+}
+
+void
+EventProfiler::regStats(const std::string &name)
+{
+    serviced
+        .name(name + ".serviced")
+        .desc("Number of events serviced")
+        ;
+
+    hostSeconds
+        .name(name + ".hostSeconds")
+        .desc("Host time spent servicing events (s)")
+        ;
+
+    // One entry per event type, the last one collects the event
+    // types that don't fit.
+    eventCount
+        .init(maxEntries + 1)
+        .name(name + ".eventCount")
+        .desc("Number of events serviced per event type")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    eventHostSeconds
+        .init(maxEntries + 1)
+        .name(name + ".eventHostSeconds")
+        .desc("Host time spent servicing events per event type (s)")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    for (unsigned i = 0; i < maxEntries; ++i) {
+        eventCount.subname(i, csprintf("unused%d", i));
+        eventHostSeconds.subname(i, csprintf("unused%d", i));
+    }
+    eventCount.subname(maxEntries, "other");
+    eventHostSeconds.subname(maxEntries, "other");
+}
+
+size_t
+EventProfiler::lookup(const std::string &type)
+{
+    auto it = typeIndex.find(type);
+    if (it != typeIndex.end())
+        return it->second;
+
+    const size_t slot = std::min<size_t>(entries.size(), maxEntries);
+    if (slot < maxEntries) {
+        // Event types are free text, turn them into something that
+        // stat parsers can cope with.
+        std::string subname(type);
+        for (auto &c : subname) {
+            if (!isalnum(c) && c != '.')
+                c = '_';
+        }
+        eventCount.subname(slot, subname);
+        eventHostSeconds.subname(slot, subname);
+    }
+
+    entries.push_back(Entry{type, slot, 0, 0.0});
+    return typeIndex[type] = entries.size() - 1;
+}
+
+void
+EventProfiler::report(std::ostream &os) const
+{
+    std::vector<const Entry *> sorted;
+    Counter total_count = 0;
+    double total_secs = 0;
+    for (const auto &entry : entries) {
+        sorted.push_back(&entry);
+        total_count += entry.count;
+        total_secs += entry.hostSeconds;
+    }
+
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Entry *l, const Entry *r) {
+                  return l->hostSeconds > r->hostSeconds;
+              });
+
+    ccprintf(os, "%12s %14s %7s %10s  %s\n",
+             "host_secs", "events", "%time", "ns/event", "event");
+    for (const auto entry : sorted) {
+        ccprintf(os, "%12.6f %14d %6.2f%% %10.1f  %s\n",
+                 entry->hostSeconds, entry->count,
+                 total_secs > 0 ? 100 * entry->hostSeconds / total_secs : 0,
+                 entry->count ? 1e9 * entry->hostSeconds / entry->count : 0,
+                 entry->type);
+    }
+    ccprintf(os, "%12.6f %14d %6.2f%% %10.1f  %s\n",
+             total_secs, total_count, total_secs > 0 ? 100.0 : 0.0,
+             total_count ? 1e9 * total_secs / total_count : 0, "total");
+}
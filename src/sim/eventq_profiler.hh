@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Host time profiling of the events serviced by an event queue.
+ */
+
+#ifndef __SIM_EVENTQ_PROFILER_HH__
+#define __SIM_EVENTQ_PROFILER_HH__
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "sim/eventq.hh"
+
+/**
+ * Account for the host time spent servicing events.
+ *
+ * When a profiler is attached to an EventQueue, serviceOne() hands
+ * every event that isn't squashed to process(), which times the call
+ * to Event::process() and accumulates the number of serviced events
+ * and host time per event type. An event type is either the event's
+ * description() or, if the profiler is keyed by name, its name().
+ * Queues without a profiler only pay for a single branch per event.
+ *
+ * The results are reported as stats, with one entry per event type up
+ * to a configurable limit (additional types are lumped together), and
+ * as a text report with all event types sorted by host time.
+ */
+class EventProfiler
+{
+  public:
+    /**
+     * @param by_name Key event types by name() rather than
+     * description().
+     * @param max_entries Number of event types reported as stats.
+     */
+    EventProfiler(bool by_name, unsigned max_entries);
+
+    void regStats(const std::string &name);
+
+    /** Process an event and account for the host time it took. */
+    void
+    process(Event *event)
+    {
+        // Look up the event type before processing the event since
+        // some events delete themselves when processed.
+        const size_t idx = lookup(event);
+
+        const auto start = std::chrono::steady_clock::now();
+        event->process();
+        const std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+
+        Entry &entry = entries[idx];
+        ++entry.count;
+        entry.hostSeconds += secs.count();
+
+        ++serviced;
+        hostSeconds += secs.count();
+        eventCount[entry.slot]++;
+        eventHostSeconds[entry.slot] += secs.count();
+    }
+
+    /** Print all event types sorted by decreasing host time. */
+    void report(std::ostream &os) const;
+
+  private:
+    struct Entry
+    {
+        std::string type;
+        /** Stats vector index used for this event type */
+        size_t slot;
+        Counter count;
+        double hostSeconds;
+    };
+
+    /** Find or allocate the entry for an event's type. */
+    size_t
+    lookup(const Event *event)
+    {
+        if (!byName) {
+            // Descriptions are static strings, so the common case is
+            // a lookup on the string pointer.
+            const char *desc = event->description();
+            auto it = descIndex.find(desc);
+            if (it != descIndex.end())
+                return it->second;
+            return descIndex[desc] = lookup(std::string(desc));
+        }
+
+        return lookup(event->name());
+    }
+
+    size_t lookup(const std::string &type);
+
+    const bool byName;
+    const unsigned maxEntries;
+
+    /** Cumulative results, never reset */
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, size_t> typeIndex;
+    std::unordered_map<const char *, size_t> descIndex;
+
+    Stats::Scalar serviced;
+    Stats::Scalar hostSeconds;
+    Stats::Vector eventCount;
+    Stats::Vector eventHostSeconds;
+};
+
+#endif // __SIM_EVENTQ_PROFILER_HH__
@@ -31,10 +31,14 @@
 
 #include "sim/global_event.hh"
 
+#include "sim/adaptive_quantum.hh"
+
 std::mutex BaseGlobalEvent::globalQMutex;
 
+Barrier::Duration BaseGlobalEvent::barrierSpin = Barrier::Duration::zero();
+
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
-    : barrier(numMainEventQueues),
+    : barrier(numMainEventQueues, barrierSpin),
       barrierEvent(numMainEventQueues, NULL)
 {
 }
@@ -140,6 +144,9 @@ GlobalEvent::BarrierEvent::process()
 void
 GlobalSyncEvent::BarrierEvent::process()
 {
+    if (adaptiveQuantum)
+        adaptiveQuantum->arrive();
+
     // wait for all queues to arrive at barrier, then process event
     if (globalBarrier()) {
         _globalEvent->process();
@@ -155,6 +162,8 @@ void
 GlobalSyncEvent::process()
 {
     if (repeat) {
+        if (adaptiveQuantum)
+            repeat = adaptiveQuantum->update(repeat);
         schedule(curTick() + repeat);
     }
 }
@@ -32,6 +32,7 @@
 #ifndef __SIM_GLOBAL_EVENT_HH__
 #define __SIM_GLOBAL_EVENT_HH__
 
+#include <chrono>
 #include <mutex>
 #include <vector>
 
@@ -99,8 +100,13 @@ class BaseGlobalEvent : public EventBase
             // locked when entering this method. We need to unlock it
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
-            EventQueue::ScopedRelease release(curEventQueue());
-            return _globalEvent->barrier.wait();
+            EventQueue *eventq = curEventQueue();
+            EventQueue::ScopedRelease release(eventq);
+            const auto start = std::chrono::steady_clock::now();
+            const bool last = _globalEvent->barrier.wait();
+            eventq->addHostBarrierTime(std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count());
+            return last;
         }
 
       public:
@@ -115,6 +121,10 @@ class BaseGlobalEvent : public EventBase
     std::vector<BarrierEvent *> barrierEvent;
 
   public:
+    //! Host time threads spin at the barrier of a global event before
+    //! blocking, applies to global events created afterwards.
+    static Barrier::Duration barrierSpin;
+
     BaseGlobalEvent(Priority p, Flags f);
 
     virtual ~BaseGlobalEvent();
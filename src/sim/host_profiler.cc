@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "sim/host_profiler.hh"
+
+#include <cerrno>
+#include <cstring>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/misc.hh"
+
+const HostProfiler::HostEvent HostProfiler::hostEvents[] = {
+    { "instructions", "Host instructions executed",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "cycles", "Host cycles",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "llcMisses", "Host last level cache misses",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "cacheReferences", "Host last level cache references",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+    { "branches", "Host branches executed",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+    { "branchMisses", "Host branches mispredicted",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "pageFaults", "Host page faults",
+      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { "contextSwitches", "Host context switches",
+      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { NULL, NULL, 0, 0 }
+};
+
+HostProfiler::QueueCounters::QueueCounters(HostProfiler &_profiler)
+    : profiler(_profiler), last(_profiler.events.size(), 0), opened(false)
+{
+}
+
+void
+HostProfiler::QueueCounters::open()
+{
+    opened = true;
+
+    for (const HostEvent *event : profiler.events) {
+        PerfKvmCounterConfig config(event->type, event->config);
+        config.exclude_kernel(profiler.excludeKernel)
+            .exclude_hv(true)
+            // The group is enabled and disabled through its leader
+            .disabled(counters.empty());
+
+        PerfKvmCounter *counter = new PerfKvmCounter();
+        if (!counter->tryAttach(config, 0,
+                                counters.empty() ? NULL : counters[0].get())) {
+            warn_once("%s: Failed to open the host event %s (%s), host "
+                      "counters are disabled.\n", profiler.name(),
+                      event->name, strerror(errno));
+            delete counter;
+            counters.clear();
+            return;
+        }
+        counters.emplace_back(counter);
+    }
+}
+
+void
+HostProfiler::QueueCounters::enterHostLoop()
+{
+    if (!opened)
+        open();
+
+    if (!counters.empty())
+        counters[0]->start();
+}
+
+void
+HostProfiler::QueueCounters::exitHostLoop()
+{
+    if (!counters.empty())
+        counters[0]->stop();
+}
+
+void
+HostProfiler::QueueCounters::read(std::vector<uint64_t> &counts)
+{
+    counts.assign(last.size(), 0);
+    for (size_t i = 0; i < counters.size(); ++i) {
+        const uint64_t value = counters[i]->read();
+        counts[i] = value - last[i];
+        last[i] = value;
+    }
+}
+
+HostProfiler::HostProfiler(const Params *p)
+    : SimObject(p), excludeKernel(p->exclude_kernel)
+{
+    for (const auto &name : p->events) {
+        const HostEvent *event = hostEvents;
+        while (event->name && name != event->name)
+            ++event;
+
+        if (!event->name) {
+            std::string valid;
+            for (event = hostEvents; event->name; ++event)
+                valid += csprintf(" %s", event->name);
+            fatal("%s: Unknown host event '%s', valid events are:%s\n",
+                  this->name(), name, valid);
+        }
+
+        events.push_back(event);
+    }
+}
+
+HostProfiler::~HostProfiler()
+{
+    for (uint32_t i = 0; i < queues.size(); ++i)
+        mainEventQueue[i]->hostLoopListener(NULL);
+}
+
+void
+HostProfiler::init()
+{
+    SimObject::init();
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        QueueCounters *counters = new QueueCounters(*this);
+        mainEventQueue[i]->hostLoopListener(counters);
+        queues.emplace_back(counters);
+    }
+}
+
+Stats::Vector *
+HostProfiler::count(const std::string &event) const
+{
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (event == events[i]->name)
+            return counts[i].get();
+    }
+    return NULL;
+}
+
+void
+HostProfiler::regStats()
+{
+    SimObject::regStats();
+
+    for (const HostEvent *event : events) {
+        Stats::Vector *stat = new Stats::Vector();
+        counts.emplace_back(stat);
+
+        stat->init(numMainEventQueues)
+            .name(name() + "." + event->name)
+            .desc(event->desc)
+            ;
+        if (numMainEventQueues > 1)
+            stat->flags(Stats::total);
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            stat->subname(i, csprintf("eventq%d", i));
+    }
+
+    Stats::Vector *insts = count("instructions");
+    Stats::Vector *cycles = count("cycles");
+    Stats::Vector *llc_misses = count("llcMisses");
+    Stats::Vector *branch_misses = count("branchMisses");
+
+    if (insts && cycles) {
+        ipc.reset(new Stats::Formula());
+        ipc->name(name() + ".ipc")
+            .desc("Host instructions per host cycle")
+            .precision(6)
+            ;
+        *ipc = sum(*insts) / sum(*cycles);
+    }
+
+    if (insts && llc_misses) {
+        llcMPKI.reset(new Stats::Formula());
+        llcMPKI->name(name() + ".llcMPKI")
+            .desc("Host last level cache misses per 1000 host instructions")
+            .precision(6)
+            ;
+        *llcMPKI = 1000 * sum(*llc_misses) / sum(*insts);
+    }
+
+    if (insts && branch_misses) {
+        branchMPKI.reset(new Stats::Formula());
+        branchMPKI->name(name() + ".branchMPKI")
+            .desc("Host branch mispredictions per 1000 host instructions")
+            .precision(6)
+            ;
+        *branchMPKI = 1000 * sum(*branch_misses) / sum(*insts);
+    }
+
+    Stats::registerDumpCallback(
+        new MakeCallback<HostProfiler, &HostProfiler::update>(this, true));
+    Stats::registerResetCallback(
+        new MakeCallback<HostProfiler, &HostProfiler::discard>(this, true));
+}
+
+void
+HostProfiler::update()
+{
+    std::vector<uint64_t> values;
+    for (uint32_t i = 0; i < queues.size(); ++i) {
+        queues[i]->read(values);
+        for (size_t e = 0; e < counts.size(); ++e)
+            (*counts[e])[i] += values[e];
+    }
+}
+
+void
+HostProfiler::discard()
+{
+    std::vector<uint64_t> values;
+    for (auto &queue : queues)
+        queue->read(values);
+}
+
+HostProfiler *
+HostProfilerParams::create()
+{
+    return new HostProfiler(this);
+}
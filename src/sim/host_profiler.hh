@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Host hardware performance counters reported as stats.
+ */
+
+#ifndef __SIM_HOST_PROFILER_HH__
+#define __SIM_HOST_PROFILER_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "cpu/kvm/perfevent.hh"
+#include "params/HostProfiler.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Measures the simulator itself with the host's performance counters
+ * (e.g., host instructions, cycles, LLC misses and branch
+ * mispredictions) and reports them as stats, next to hostSeconds and
+ * friends. Since they are stats, they are reset and dumped with the
+ * other stats and thus follow the phases of the workload.
+ *
+ * Every thread servicing a main event queue counts the events on its
+ * own, and only while it is in the simulation loop, so the time spent
+ * in Python between calls to simulate() isn't included. The counters
+ * of a thread are opened in a single group so that ratios such as
+ * host IPC are consistent. The group has to fit in the host's
+ * counters, otherwise it is multiplexed out and counts nothing.
+ *
+ * If the host refuses to open the counters (e.g., because of
+ * /proc/sys/kernel/perf_event_paranoid), the profiler warns and the
+ * stats stay at zero.
+ */
+class HostProfiler : public SimObject
+{
+  protected:
+    /** Host event that can be counted */
+    struct HostEvent
+    {
+        const char *name;
+        const char *desc;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static const HostEvent hostEvents[];
+
+    /** Counters of the thread servicing one event queue */
+    class QueueCounters : public EventQueue::HostLoopListener
+    {
+      protected:
+        HostProfiler &profiler;
+
+        /** The first counter is the group leader */
+        std::vector<std::unique_ptr<PerfKvmCounter>> counters;
+
+        /** Counter values when they were last read */
+        std::vector<uint64_t> last;
+
+        bool opened;
+
+        /** Open the counters in the calling thread */
+        void open();
+
+      public:
+        QueueCounters(HostProfiler &profiler);
+
+        void enterHostLoop() override;
+        void exitHostLoop() override;
+
+        /**
+         * Get the counts since the last call, or zero if the counters
+         * couldn't be opened.
+         */
+        void read(std::vector<uint64_t> &counts);
+    };
+
+    /** Events counted, each in a separate counter */
+    std::vector<const HostEvent *> events;
+    const bool excludeKernel;
+
+    std::vector<std::unique_ptr<QueueCounters>> queues;
+
+    /** Host events per event type, one entry per event queue */
+    std::vector<std::unique_ptr<Stats::Vector>> counts;
+
+    /** @{ Ratios of the events, only registered if all are counted */
+    std::unique_ptr<Stats::Formula> ipc;
+    std::unique_ptr<Stats::Formula> llcMPKI;
+    std::unique_ptr<Stats::Formula> branchMPKI;
+    /** @} */
+
+    /** Stats entry of an event type, or NULL if it isn't counted */
+    Stats::Vector *count(const std::string &event) const;
+
+    /** Add the counts since the last dump to the stats */
+    void update();
+    /** Discard the counts since the last dump on a stats reset */
+    void discard();
+
+  public:
+    typedef HostProfilerParams Params;
+    HostProfiler(const Params *p);
+    ~HostProfiler();
+
+    void init() override;
+    void regStats() override;
+};
+
+#endif // __SIM_HOST_PROFILER_HH__
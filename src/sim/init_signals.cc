@@ -133,6 +133,16 @@ exitNowHandler(int sigtype)
     getEventQueue(0)->wakeup();
 }
 
+/// Flight recorder dump signal handler.
+void
+flightRecorderHandler(int sigtype)
+{
+    async_event = true;
+    async_recorderdump = true;
+    /* Wake up some event queue to handle event */
+    getEventQueue(0)->wakeup();
+}
+
 /// Abort signal handler.
 void
 abortHandler(int sigtype)
@@ -207,3 +217,13 @@ initSignals()
     installSignalHandler(SIGIO, ioHandler);
 }
 
+/*
+ * Only take over SIGHUP once there is something to dump, it otherwise
+ * keeps its default meaning.
+ */
+void
+initFlightRecorderSignal()
+{
+    installSignalHandler(SIGHUP, flightRecorderHandler);
+}
+
@@ -35,6 +35,8 @@ void dumpStatsHandler(int sigtype);
 void dumprstStatsHandler(int sigtype);
 void exitNowHandler(int sigtype);
 void abortHandler(int sigtype);
+void flightRecorderHandler(int sigtype);
 void initSignals();
+void initFlightRecorderSignal();
 
 #endif // __SIM_INIT_SIGNALS_HH__
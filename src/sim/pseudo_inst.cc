@@ -69,6 +69,7 @@
 #include "debug/WorkItems.hh"
 #include "dev/net/dist_iface.hh"
 #include "params/BaseCPU.hh"
+#include "sim/core.hh"
 #include "sim/full_system.hh"
 #include "sim/initparam_keys.hh"
 #include "sim/process.hh"
@@ -197,8 +198,11 @@ pseudoInst(ThreadContext *tc, uint8_t func, uint8_t subfunc)
         workend(tc, args[0], args[1]);
         break;
 
+      case M5OP_DUMP_TRACE:
+        dumptrace(tc);
+        break;
+
       case M5OP_ANNOTATE:
-      case M5OP_RESERVED2:
       case M5OP_RESERVED3:
       case M5OP_RESERVED4:
       case M5OP_RESERVED5:
@@ -582,6 +586,13 @@ debugbreak(ThreadContext *tc)
     Debug::breakpoint();
 }
 
+void
+dumptrace(ThreadContext *tc)
+{
+    DPRINTF(PseudoInst, "PseudoInst::dumptrace()\n");
+    dumpFlightRecorders();
+}
+
 void
 switchcpu(ThreadContext *tc)
 {
@@ -31,12 +31,18 @@
  *          Gabe Black
  */
 
+#include <chrono>
+
+#include "base/callback.hh"
 #include "base/misc.hh"
+#include "base/output.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/TimeSync.hh"
+#include "sim/core.hh"
 #include "sim/eventq_impl.hh"
 #include "sim/full_system.hh"
+#include "sim/global_event.hh"
 #include "sim/root.hh"
 
 Root *Root::_root = NULL;
@@ -116,6 +122,30 @@ Root::Root(RootParams *p)
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+
+    Time barrier_spin;
+    barrier_spin.setTick(p->sim_barrier_spin);
+    BaseGlobalEvent::barrierSpin = std::chrono::seconds(barrier_spin.sec()) +
+        std::chrono::nanoseconds(barrier_spin.nsec());
+
+    if (p->sim_quantum_adaptive) {
+        _adaptiveQuantum.reset(new AdaptiveQuantum(
+            p->sim_quantum_min ? p->sim_quantum_min : p->sim_quantum,
+            p->sim_quantum_max ? p->sim_quantum_max : p->sim_quantum,
+            p->sim_quantum_interval, p->sim_quantum_wait_target,
+            p->sim_quantum_interaction_limit));
+        fatal_if(simQuantum < _adaptiveQuantum->minQuantum() ||
+                 simQuantum > _adaptiveQuantum->maxQuantum(),
+                 "sim_quantum is outside of the adaptive quantum bounds\n");
+        adaptiveQuantum = _adaptiveQuantum.get();
+    }
+
+    // Queues may already have been created by the Python code or by
+    // other SimObjects, convert them to the configured backend too.
+    EventQueue::defaultBackend = p->eventq_backend == Enums::calendar ?
+        EventQueue::Calendar : EventQueue::SortedList;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->backend(EventQueue::defaultBackend);
 }
 
 void
@@ -124,6 +154,101 @@ Root::initState()
     timeSyncEnable(params()->time_sync_enable);
 }
 
+void
+Root::init()
+{
+    SimObject::init();
+
+    if (adaptiveQuantum)
+        adaptiveQuantum->init();
+}
+
+void
+Root::regStats()
+{
+    SimObject::regStats();
+
+    if (adaptiveQuantum)
+        adaptiveQuantum->regStats(name() + ".quantum");
+
+    if (numMainEventQueues > 1) {
+        threadStats.reset(new ThreadStats);
+
+        threadStats->runSeconds
+            .init(numMainEventQueues)
+            .name(name() + ".threads.runSeconds")
+            .desc("Host time each thread spent servicing events")
+            .flags(Stats::total)
+            ;
+
+        threadStats->barrierSeconds
+            .init(numMainEventQueues)
+            .name(name() + ".threads.barrierSeconds")
+            .desc("Host time each thread spent waiting at global barriers")
+            .flags(Stats::total)
+            ;
+
+        threadStats->efficiency
+            .name(name() + ".threads.efficiency")
+            .desc("Fraction of host time each thread spent servicing events")
+            ;
+        threadStats->efficiency =
+            threadStats->runSeconds /
+            (threadStats->runSeconds + threadStats->barrierSeconds);
+
+        Stats::registerDumpCallback(
+            new MakeCallback<Root, &Root::updateThreadStats>(this, true));
+        Stats::registerResetCallback(
+            new MakeCallback<Root, &Root::resetThreadStats>(this, true));
+    }
+
+    if (!params()->eventq_profile)
+        return;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        EventProfiler *profiler =
+            new EventProfiler(params()->eventq_profile_by_name,
+                              params()->eventq_profile_entries);
+        profiler->regStats(csprintf("%s.eventq%d", name(), i));
+        mainEventQueue[i]->profiler(profiler);
+        eventqProfilers.emplace_back(profiler);
+    }
+
+    registerExitCallback(
+        new MakeCallback<Root, &Root::eventqProfileReport>(this, true));
+}
+
+void
+Root::updateThreadStats()
+{
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        double run_seconds, barrier_seconds;
+        mainEventQueue[i]->takeHostTimes(run_seconds, barrier_seconds);
+        threadStats->runSeconds[i] += run_seconds;
+        threadStats->barrierSeconds[i] += barrier_seconds;
+    }
+}
+
+void
+Root::resetThreadStats()
+{
+    double run_seconds, barrier_seconds;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->takeHostTimes(run_seconds, barrier_seconds);
+}
+
+void
+Root::eventqProfileReport()
+{
+    OutputStream *os = simout.create("eventq_profile.txt");
+    for (uint32_t i = 0; i < eventqProfilers.size(); ++i) {
+        ccprintf(*os->stream(), "%s\n", mainEventQueue[i]->name());
+        eventqProfilers[i]->report(*os->stream());
+        ccprintf(*os->stream(), "\n");
+    }
+    simout.close(os);
+}
+
 void
 Root::loadState(CheckpointIn &cp)
 {
@@ -41,9 +41,15 @@
 #ifndef __SIM_ROOT_HH__
 #define __SIM_ROOT_HH__
 
+#include <memory>
+#include <vector>
+
+#include "base/statistics.hh"
 #include "base/time.hh"
 #include "params/Root.hh"
+#include "sim/adaptive_quantum.hh"
 #include "sim/eventq.hh"
+#include "sim/eventq_profiler.hh"
 #include "sim/sim_object.hh"
 
 class Root : public SimObject
@@ -62,6 +68,33 @@ class Root : public SimObject
     void timeSync();
     EventFunctionWrapper syncEvent;
 
+    /** Host time profilers of the main event queues, if enabled */
+    std::vector<std::unique_ptr<EventProfiler>> eventqProfilers;
+
+    /** Write the event queue profiles to eventq_profile.txt */
+    void eventqProfileReport();
+
+    /** Controller of the adaptive simulation quantum, if enabled */
+    std::unique_ptr<AdaptiveQuantum> _adaptiveQuantum;
+
+    /**
+     * Host time per simulation thread spent servicing events and
+     * waiting at global barriers. Only allocated when simulating with
+     * multiple event queues since stats can't be left unregistered.
+     */
+    struct ThreadStats
+    {
+        Stats::Vector runSeconds;
+        Stats::Vector barrierSeconds;
+        Stats::Formula efficiency;
+    };
+    std::unique_ptr<ThreadStats> threadStats;
+
+    /** Collect the host time of the threads before a stats dump */
+    void updateThreadStats();
+    /** Discard the host time of the threads on a stats reset */
+    void resetThreadStats();
+
   public:
     /**
      * Use this function to get a pointer to the single Root object in the
@@ -111,6 +144,9 @@ class Root : public SimObject
      */
     void initState() override;
 
+    void init() override;
+    void regStats() override;
+
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 };
@@ -56,7 +56,8 @@ SimObject::SimObjectList SimObject::simObjectList;
 // SimObject constructor: used to maintain static simObjectList
 //
 SimObject::SimObject(const Params *p)
-    : EventManager(getEventQueue(p->eventq_index)), _params(p)
+    : EventManager(getEventQueue(p->eventq_index)), _params(p),
+      _name(p->name)
 {
 #ifdef DEBUG
     doDebugBreak = false;
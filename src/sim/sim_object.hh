@@ -52,6 +52,7 @@
 #include <string>
 #include <vector>
 
+#include "base/trace.hh"
 #include "params/SimObject.hh"
 #include "sim/drain.hh"
 #include "sim/eventq.hh"
@@ -106,6 +107,10 @@ class SimObject : public EventManager, public Serializable, public Drainable
     /** Cached copy of the object parameters. */
     const SimObjectParams *_params;
 
+  private:
+    /** Name of the object, which says whether the object is traced. */
+    const Trace::ObjectName _name;
+
   public:
     typedef SimObjectParams Params;
     const Params *params() const { return _params; }
@@ -114,7 +119,7 @@ class SimObject : public EventManager, public Serializable, public Drainable
 
   public:
 
-    virtual const std::string name() const { return params()->name; }
+    virtual const Trace::ObjectName &name() const { return _name; }
 
     /**
      * init() is called after all C++ SimObjects have been created and
@@ -40,6 +40,7 @@
 #include "base/pollevent.hh"
 #include "base/types.hh"
 #include "sim/async.hh"
+#include "sim/core.hh"
 #include "sim/eventq_impl.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
@@ -183,6 +184,14 @@ doSimLoop(EventQueue *eventq)
     curEventQueue(eventq);
     eventq->handleAsyncInsertions();
 
+    // account the host time of this thread until the loop is left
+    struct HostLoopScope
+    {
+        EventQueue *eventq;
+        HostLoopScope(EventQueue *q) : eventq(q) { eventq->enterHostLoop(); }
+        ~HostLoopScope() { eventq->exitHostLoop(); }
+    } host_loop_scope(eventq);
+
     while (1) {
         // there should always be at least one event (the SimLoopExitEvent
         // we just scheduled) in the queue
@@ -200,6 +209,11 @@ doSimLoop(EventQueue *eventq)
                 async_statreset = false;
             }
 
+            if (async_recorderdump) {
+                async_recorderdump = false;
+                dumpFlightRecorders();
+            }
+
             if (async_io) {
                 async_io = false;
                 pollQueue.service();
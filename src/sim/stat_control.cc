@@ -117,6 +117,10 @@ struct Global
     Stats::Value simInsts;
     Stats::Value simOps;
 
+    Stats::Value hostEventAllocs;
+    Stats::Value hostEventHeapAllocs;
+    Stats::Formula hostEventAllocsSaved;
+
     Global();
 };
 
@@ -196,10 +200,34 @@ Global::Global()
         .precision(0)
         ;
 
+    hostEventAllocs
+        .functor(EventPool::totalAllocs)
+        .name("host_event_allocs")
+        .desc("Number of events allocated from the event pools")
+        .precision(0)
+        .prereq(hostEventAllocs)
+        ;
+
+    hostEventHeapAllocs
+        .functor(EventPool::totalHeapAllocs)
+        .name("host_event_heap_allocs")
+        .desc("Number of event pool allocations from the host heap")
+        .precision(0)
+        .prereq(hostEventAllocs)
+        ;
+
+    hostEventAllocsSaved
+        .name("host_event_allocs_saved")
+        .desc("Number of host heap allocations saved by the event pools")
+        .precision(0)
+        .prereq(hostEventAllocs)
+        ;
+
     simSeconds = simTicks / simFreq;
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
     hostTickRate = simTicks / hostSeconds;
+    hostEventAllocsSaved = hostEventAllocs - hostEventHeapAllocs;
 
     registerResetCallback(&simTicksReset);
 }
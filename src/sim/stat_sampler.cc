@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "sim/stat_sampler.hh"
+
+#include <algorithm>
+
+#include "base/match.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "base/stats/info.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+StatSampler::Series::Series(size_t buffer_size)
+    : bufferSize(buffer_size)
+{
+}
+
+void
+StatSampler::Series::begin()
+{
+    Binary::begin();
+
+    if (!schemaDone)
+        levels.assign(1, true);
+    add("tick", "Tick of the sample", curTick());
+}
+
+void
+StatSampler::Series::visit(const Stats::FormulaInfo &info)
+{
+    const size_t first = record.size();
+    Binary::visit(info);
+
+    if (!schemaDone) {
+        levels.resize(first, false);
+        levels.resize(record.size(), true);
+    }
+}
+
+void
+StatSampler::Series::writeRecord()
+{
+    levels.resize(record.size(), false);
+    previous.resize(record.size(), 0);
+
+    for (size_t i = 0; i < record.size(); ++i) {
+        if (levels[i])
+            continue;
+
+        const double value = record[i];
+        record[i] = value - previous[i];
+        previous[i] = value;
+    }
+
+    pending.insert(pending.end(), record.begin(), record.end());
+    if (pending.size() * sizeof(double) >= bufferSize)
+        flush();
+}
+
+void
+StatSampler::Series::reset()
+{
+    fill(previous.begin(), previous.end(), 0);
+}
+
+void
+StatSampler::Series::flush()
+{
+    if (!stream || pending.empty())
+        return;
+
+    stream->write(reinterpret_cast<const char *>(pending.data()),
+                  pending.size() * sizeof(double));
+    stream->flush();
+    pending.clear();
+}
+
+StatSampler::StatSampler(const Params *p)
+    : SimObject(p), patterns(p->stats), period(p->period),
+      filename(p->file), file(nullptr), series(p->buffer_size),
+      sampleEvent([this]{ sample(); }, name(), false,
+                  Event::Stat_Event_Pri),
+      resetCallback(series), exitCallback(series)
+{
+    if (period == 0)
+        fatal("%s: the sampling period must not be zero\n", name());
+
+    Stats::registerResetCallback(&resetCallback);
+    registerExitCallback(&exitCallback);
+}
+
+void
+StatSampler::select()
+{
+    for (const string &pattern : patterns) {
+        const ObjectMatch match(pattern);
+        bool found = false;
+
+        for (Stats::Info *info : Stats::statsList()) {
+            if (!match.match(info->name))
+                continue;
+
+            found = true;
+            if (!dynamic_cast<Stats::ScalarInfo *>(info) &&
+                !dynamic_cast<Stats::VectorInfo *>(info) &&
+                !dynamic_cast<Stats::Vector2dInfo *>(info)) {
+                warn("%s: distributions cannot be sampled, ignoring %s\n",
+                     name(), info->name);
+                continue;
+            }
+
+            if (std::find(selected.begin(), selected.end(), info) ==
+                selected.end())
+                selected.push_back(info);
+        }
+
+        if (!found)
+            warn("%s: no stat matches '%s'\n", name(), pattern);
+    }
+}
+
+void
+StatSampler::startup()
+{
+    select();
+    if (selected.empty()) {
+        warn("%s: no stats to sample\n", name());
+        return;
+    }
+
+    file = simout.create(filename, true);
+    series.open(*file->stream());
+    schedule(sampleEvent, curTick() + period);
+}
+
+void
+StatSampler::sample()
+{
+    series.begin();
+    for (Stats::Info *info : selected) {
+        info->prepare();
+        info->visit(series);
+    }
+    series.end();
+
+    schedule(sampleEvent, curTick() + period);
+}
+
+StatSampler *
+StatSamplerParams::create()
+{
+    return new StatSampler(this);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Periodic sampling of selected stats into a time-series.
+ */
+
+#ifndef __SIM_STAT_SAMPLER_HH__
+#define __SIM_STAT_SAMPLER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/stats/binary.hh"
+#include "params/StatSampler.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+class OutputStream;
+
+namespace Stats {
+class Info;
+}
+
+/**
+ * Reads a few selected stats at a fixed period and appends them to a
+ * time-series in the binary stats format, one record per sample,
+ * starting with the tick of the sample. Counters are written as their
+ * change since the previous sample, formulas (e.g., IPC or miss
+ * rates) as their value at the sample.
+ *
+ * Only the selected stats are read, and nothing is formatted or
+ * reset, so sampling is much cheaper than a stats dump at the same
+ * period. Samples are kept in memory up to buffer_size bytes before
+ * being written, compressed if the file name ends in .gz.
+ */
+class StatSampler : public SimObject
+{
+  protected:
+    class Series : public Stats::Binary
+    {
+      protected:
+        /** Columns written as values rather than as changes */
+        std::vector<bool> levels;
+
+        /** Values of the previous sample */
+        std::vector<double> previous;
+
+        /** Samples waiting to be written */
+        std::vector<double> pending;
+        size_t bufferSize;
+
+        void writeRecord() override;
+
+      public:
+        Series(size_t buffer_size);
+
+        void begin() override;
+        using Binary::visit;
+        void visit(const Stats::FormulaInfo &info) override;
+
+        /** The stats were reset, count changes from zero */
+        void reset();
+
+        /** Write the pending samples */
+        void flush();
+    };
+
+    /** Stats to sample, resolved at startup */
+    std::vector<Stats::Info *> selected;
+    const std::vector<std::string> patterns;
+
+    const Tick period;
+    const std::string filename;
+    OutputStream *file;
+    Series series;
+
+    EventFunctionWrapper sampleEvent;
+
+    MakeCallback<Series, &Series::reset> resetCallback;
+    MakeCallback<Series, &Series::flush> exitCallback;
+
+    void select();
+    void sample();
+
+  public:
+    typedef StatSamplerParams Params;
+    StatSampler(const Params *p);
+
+    void startup() override;
+};
+
+#endif // __SIM_STAT_SAMPLER_HH__
@@ -101,7 +101,11 @@ System::System(Params *p)
 #else
       kvmVM(nullptr),
 #endif
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->incremental_checkpoint,
+              p->checkpoint_memory_format == Enums::raw ?
+              PhysicalMemory::RawStore : PhysicalMemory::GzipStore,
+              p->checkpoint_compress_threads),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "base/barrier.hh"
+#include "base/cprintf.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+/**
+ * Let a number of threads pass a barrier repeatedly. Every thread
+ * checks that all threads arrived at the barrier before it left it,
+ * and that exactly one thread per generation was told it was the last
+ * one to arrive.
+ *
+ * @return Barrier generations per host second.
+ */
+double
+passBarrier(unsigned num_threads, unsigned generations,
+            Barrier::Duration spin, bool &ordered, bool &one_leader)
+{
+    Barrier barrier(num_threads, spin);
+    atomic<unsigned> arrivals(0);
+    atomic<unsigned> leaders(0);
+    atomic<bool> early(false);
+
+    auto body = [&]() {
+        for (unsigned gen = 1; gen <= generations; ++gen) {
+            arrivals.fetch_add(1);
+            if (barrier.wait())
+                leaders.fetch_add(1);
+            if (arrivals.load() < gen * num_threads)
+                early = true;
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (unsigned i = 1; i < num_threads; ++i)
+        threads.emplace_back(body);
+    body();
+    for (auto &t : threads)
+        t.join();
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+    ordered = !early;
+    one_leader = leaders == generations;
+    return generations / secs.count();
+}
+
+int
+main(int argc, char *argv[])
+{
+    const unsigned num_threads =
+        max(2u, min(4u, thread::hardware_concurrency()));
+    bool ordered, one_leader;
+
+    UnitTest::setCase("Blocking barrier");
+    double block_rate = passBarrier(num_threads, 20000,
+                                    Barrier::Duration::zero(),
+                                    ordered, one_leader);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(one_leader);
+
+    UnitTest::setCase("Spinning barrier");
+    double spin_rate = passBarrier(num_threads, 20000,
+                                   chrono::microseconds(50),
+                                   ordered, one_leader);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(one_leader);
+
+    UnitTest::setCase("Spin budget exhausted");
+    passBarrier(num_threads, 2000, chrono::nanoseconds(100),
+                ordered, one_leader);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(one_leader);
+
+    cprintf("%d threads: blocking %.0f barriers/s, spinning %.0f "
+            "barriers/s\n", num_threads, block_rate, spin_rate);
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq_impl.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+class TestEvent : public Event
+{
+  private:
+    vector<int> &log;
+    const int id;
+
+  public:
+    TestEvent(vector<int> &_log, int _id, Priority p)
+        : Event(p), log(_log), id(_id)
+    {}
+
+    void process() { log.push_back(id); }
+};
+
+/**
+ * Apply the same pseudo-random sequence of schedule, deschedule,
+ * reschedule and service operations to a queue and return the order
+ * in which the events were serviced.
+ */
+vector<int>
+randomOps(EventQueue::Backend backend, unsigned seed, int num_events,
+          int num_ops, Tick max_delay)
+{
+    static const Event::Priority prios[] = {
+        Event::Minimum_Pri, Event::Delayed_Writeback_Pri,
+        Event::Default_Pri, Event::CPU_Tick_Pri, Event::Sim_Exit_Pri,
+    };
+
+    vector<int> log;
+    EventQueue q("test_queue");
+    q.backend(backend);
+    curEventQueue(&q);
+
+    mt19937 rng(seed);
+    vector<TestEvent *> events;
+    for (int i = 0; i < num_events; ++i)
+        events.push_back(new TestEvent(log, i, prios[rng() % 5]));
+
+    for (int i = 0; i < num_ops; ++i) {
+        TestEvent *event = events[rng() % num_events];
+        const Tick when = q.getCurTick() + rng() % max_delay;
+        switch (rng() % 4) {
+          case 0:
+            if (!event->scheduled())
+                q.schedule(event, when);
+            break;
+          case 1:
+            if (event->scheduled())
+                q.deschedule(event);
+            break;
+          case 2:
+            q.reschedule(event, when, true);
+            break;
+          default:
+            if (!q.empty())
+                q.serviceOne();
+            break;
+        }
+
+        // Switching the backend must not change the service order
+        if (i == num_ops / 2)
+            q.backend(backend == EventQueue::Calendar ?
+                      EventQueue::SortedList : EventQueue::Calendar);
+        if (i == 3 * num_ops / 4)
+            q.backend(backend);
+    }
+
+    EXPECT_TRUE(q.debugVerify());
+    while (!q.empty())
+        q.serviceOne();
+
+    for (auto event : events)
+        delete event;
+
+    curEventQueue(NULL);
+    return log;
+}
+
+/**
+ * Keep a fixed number of periodic events pending, similar to a system
+ * with many clocked objects, and return the number of serviced events
+ * per host second.
+ */
+double
+periodicRate(EventQueue::Backend backend, int num_events, int num_services)
+{
+    vector<int> log;
+    EventQueue q("bench_queue");
+    q.backend(backend);
+    curEventQueue(&q);
+
+    mt19937 rng(0);
+    vector<Tick> periods;
+    vector<TestEvent *> events;
+    for (int i = 0; i < num_events; ++i) {
+        events.push_back(new TestEvent(log, i, Event::Default_Pri));
+        periods.push_back(250 * (1 + rng() % 16));
+        q.schedule(events.back(), rng() % periods.back());
+    }
+    log.reserve(num_services);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < num_services; ++i) {
+        q.serviceOne();
+        const int id = log.back();
+        q.schedule(events[id], q.getCurTick() + periods[id]);
+    }
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+    while (!q.empty())
+        q.deschedule(q.getHead());
+    for (auto event : events)
+        delete event;
+
+    curEventQueue(NULL);
+    return num_services / secs.count();
+}
+
+int
+main(int argc, char *argv[])
+{
+    UnitTest::setCase("Calendar queue service order");
+    for (unsigned seed = 0; seed < 16; ++seed) {
+        EXPECT_TRUE(
+            randomOps(EventQueue::SortedList, seed, 64, 4096, 4000) ==
+            randomOps(EventQueue::Calendar, seed, 64, 4096, 4000));
+    }
+
+    UnitTest::setCase("Calendar queue resizing");
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        EXPECT_TRUE(
+            randomOps(EventQueue::SortedList, seed, 4096, 65536, 1000000) ==
+            randomOps(EventQueue::Calendar, seed, 4096, 65536, 1000000));
+    }
+
+    UnitTest::setCase("Same tick ordering");
+    {
+        vector<int> log;
+        EventQueue q("order_queue");
+        q.backend(EventQueue::Calendar);
+        curEventQueue(&q);
+        TestEvent e0(log, 0, Event::Default_Pri);
+        TestEvent e1(log, 1, Event::Default_Pri);
+        TestEvent e2(log, 2, Event::CPU_Tick_Pri);
+        TestEvent e3(log, 3, Event::Minimum_Pri);
+        q.schedule(&e0, 100);
+        q.schedule(&e1, 100);
+        q.schedule(&e2, 100);
+        q.schedule(&e3, 100);
+        while (!q.empty())
+            q.serviceOne();
+        EXPECT_TRUE(log == vector<int>({3, 1, 0, 2}));
+        curEventQueue(NULL);
+    }
+
+    UnitTest::setCase("Pooled one-shot events");
+    {
+        EventQueue q("pool_queue");
+        EventManager em(&q);
+        curEventQueue(&q);
+        int count = 0;
+        const Counter heap_allocs = EventPool::totalHeapAllocs();
+        for (int i = 0; i < 100000; ++i) {
+            em.scheduleOneShot([&count]{ ++count; }, "one_shot", i);
+            if (i % 2) {
+                // Descheduled one-shot events are recycled too
+                q.deschedule(em.scheduleOneShot([]{}, "unused", i + 1));
+            }
+            q.serviceOne();
+        }
+        EXPECT_EQ(count, 100000);
+        EXPECT_TRUE(EventPool::totalHeapAllocs() - heap_allocs <= 1);
+        curEventQueue(NULL);
+    }
+
+    for (int num_events : { 16, 256, 4096 }) {
+        const int services = 200000;
+        cprintf("%d pending events: sorted list %.0f events/s, "
+                "calendar %.0f events/s\n", num_events,
+                periodicRate(EventQueue::SortedList, num_events, services),
+                periodicRate(EventQueue::Calendar, num_events, services));
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <set>
+#include <vector>
+
+#include "base/refcnt.hh"
+#include "cpu/inst_pool.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+/** Minimal stand-in for a dynamic instruction */
+class TestInst : public RefCounted, public InstPoolAllocated
+{
+  public:
+    static int live;
+
+    int value;
+    double payload[5];
+
+    TestInst(int v) : value(v) { ++live; }
+    ~TestInst() { --live; }
+};
+
+int TestInst::live = 0;
+
+typedef RefCountingPtr<TestInst> TestInstPtr;
+
+int
+main()
+{
+    InstPool pool(sizeof(TestInst), 4);
+
+    UnitTest::setCase("Storage is recycled");
+    set<void *> first;
+    {
+        vector<TestInstPtr> insts;
+        for (int i = 0; i < 4; ++i) {
+            insts.push_back(new (pool) TestInst(i));
+            first.insert(insts.back().get());
+        }
+        EXPECT_EQ(first.size(), 4);
+        EXPECT_EQ(TestInst::live, 4);
+    }
+    EXPECT_EQ(TestInst::live, 0);
+    {
+        vector<TestInstPtr> insts;
+        for (int i = 0; i < 4; ++i) {
+            insts.push_back(new (pool) TestInst(i));
+            EXPECT_TRUE(first.count(insts.back().get()));
+            EXPECT_EQ(insts.back()->value, i);
+        }
+    }
+
+    UnitTest::setCase("Pool grows when exhausted");
+    {
+        vector<TestInstPtr> insts;
+        set<void *> all;
+        for (int i = 0; i < 10; ++i) {
+            insts.push_back(new (pool) TestInst(i));
+            all.insert(insts.back().get());
+        }
+        EXPECT_EQ(all.size(), 10);
+        for (int i = 0; i < 10; ++i)
+            EXPECT_EQ(insts[i]->value, i);
+        EXPECT_EQ(TestInst::live, 10);
+    }
+    EXPECT_EQ(TestInst::live, 0);
+
+    UnitTest::setCase("Blocks are aligned");
+    {
+        TestInstPtr inst = new (pool) TestInst(0);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(inst.get()) % 16, 0);
+    }
+
+    UnitTest::setCase("Heap allocation");
+    {
+        TestInstPtr inst = new TestInst(42);
+        EXPECT_EQ(inst->value, 42);
+        EXPECT_EQ(TestInst::live, 1);
+    }
+    EXPECT_EQ(TestInst::live, 0);
+
+    return UnitTest::printResults();
+}
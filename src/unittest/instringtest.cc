@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "cpu/inst_ring.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+typedef shared_ptr<int> IntPtr;
+typedef InstRing<IntPtr> Ring;
+
+/** Sequence numbers of the ring's elements, oldest first. */
+static vector<int>
+contents(Ring &ring)
+{
+    vector<int> seqs;
+    for (Ring::iterator it = ring.begin(); it != ring.end(); ++it)
+        seqs.push_back(**it);
+    return seqs;
+}
+
+static void
+push(Ring &ring, InstSeqNum seq)
+{
+    ring.push_back(seq, make_shared<int>(seq));
+}
+
+int
+main()
+{
+    UnitTest::setCase("Program order");
+    {
+        Ring ring(4);
+        for (InstSeqNum seq = 10; seq < 20; seq += 3)
+            push(ring, seq);
+        EXPECT_EQ(ring.size(), 4);
+        EXPECT_EQ(contents(ring), vector<int>({10, 13, 16, 19}));
+        EXPECT_EQ(*ring.front(), 10);
+        EXPECT_EQ(*ring.back(), 19);
+        EXPECT_TRUE(ring.find(13) != ring.end());
+        EXPECT_TRUE(ring.find(14) == ring.end());
+        EXPECT_TRUE(ring.find(30) == ring.end());
+    }
+
+    UnitTest::setCase("Growth keeps the contents");
+    {
+        Ring ring(2);
+        for (InstSeqNum seq = 100; seq < 200; seq += 7)
+            push(ring, seq);
+        vector<int> expected;
+        for (int seq = 100; seq < 200; seq += 7)
+            expected.push_back(seq);
+        EXPECT_EQ(contents(ring), expected);
+        push(ring, 5000);
+        EXPECT_EQ(*ring.back(), 5000);
+        EXPECT_EQ(*ring.front(), 100);
+    }
+
+    UnitTest::setCase("Retire from the head");
+    {
+        Ring ring(8);
+        for (InstSeqNum seq = 1; seq <= 6; ++seq)
+            push(ring, seq);
+        ring.pop_front();
+        ring.pop_front();
+        EXPECT_EQ(contents(ring), vector<int>({3, 4, 5, 6}));
+        // Reuses the slots of the retired instructions
+        push(ring, 7);
+        push(ring, 8);
+        push(ring, 9);
+        push(ring, 10);
+        EXPECT_EQ(contents(ring), vector<int>({3, 4, 5, 6, 7, 8, 9, 10}));
+    }
+
+    UnitTest::setCase("Squash from the tail");
+    {
+        Ring ring;
+        for (InstSeqNum seq = 1; seq <= 8; ++seq)
+            push(ring, seq);
+        Ring::iterator it = ring.end();
+        --it;
+        while (it != ring.end() && **it > 4)
+            ring.erase(it--);
+        EXPECT_EQ(contents(ring), vector<int>({1, 2, 3, 4}));
+        EXPECT_EQ(*ring.back(), 4);
+
+        it = ring.end();
+        --it;
+        while (it != ring.end())
+            ring.erase(it--);
+        EXPECT_TRUE(ring.empty());
+        EXPECT_TRUE(ring.begin() == ring.end());
+
+        // An empty ring starts over from any sequence number
+        push(ring, 1000);
+        EXPECT_EQ(contents(ring), vector<int>({1000}));
+    }
+
+    UnitTest::setCase("Removal from the middle");
+    {
+        Ring ring;
+        for (InstSeqNum seq = 1; seq <= 5; ++seq)
+            push(ring, seq);
+        ring.erase(3);
+        ring.erase(ring.find(2));
+        EXPECT_EQ(contents(ring), vector<int>({1, 4, 5}));
+        ring.erase(1);
+        EXPECT_EQ(*ring.front(), 4);
+        ring.erase(5);
+        EXPECT_EQ(*ring.back(), 4);
+        EXPECT_EQ(ring.size(), 1);
+
+        Ring::iterator it = ring.begin();
+        ++it;
+        EXPECT_TRUE(it == ring.end());
+        it = ring.begin();
+        --it;
+        EXPECT_TRUE(it == ring.end());
+    }
+
+    UnitTest::setCase("Iterators survive other removals");
+    {
+        Ring ring;
+        for (InstSeqNum seq = 1; seq <= 6; ++seq)
+            push(ring, seq);
+        Ring::iterator it = ring.find(6);
+        ring.erase(it--);
+        ring.erase(4);
+        EXPECT_EQ(**it, 5);
+        --it;
+        EXPECT_EQ(**it, 3);
+
+        it = ring.begin();
+        ring.erase(it++);
+        EXPECT_EQ(**it, 2);
+    }
+
+    UnitTest::setCase("Clear");
+    {
+        Ring ring;
+        IntPtr held = make_shared<int>(1);
+        ring.push_back(1, held);
+        push(ring, 2);
+        ring.clear();
+        EXPECT_TRUE(ring.empty());
+        EXPECT_EQ(held.use_count(), 1);
+        push(ring, 3);
+        EXPECT_EQ(contents(ring), vector<int>({3}));
+    }
+
+    return UnitTest::printResults();
+}
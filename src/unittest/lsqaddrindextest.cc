@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/lsq_addr_index.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+/** Entries the index reports for an access, in queue order. */
+static vector<int>
+overlaps(const LSQAddrIndex &index, Addr addr, unsigned size)
+{
+    vector<int> found;
+    index.forEachOverlap(addr, size, [&](int idx) { found.push_back(idx); });
+    sort(found.begin(), found.end());
+    return found;
+}
+
+struct Access
+{
+    bool valid;
+    Addr addr;
+    unsigned size;
+};
+
+/** Entries sharing a granule with an access, by walking them all. */
+static vector<int>
+expected(const vector<Access> &queue, unsigned shift, Addr addr,
+         unsigned size)
+{
+    vector<int> found;
+    for (int idx = 0; idx < queue.size(); ++idx) {
+        const Access &entry = queue[idx];
+        if (entry.valid &&
+            (entry.addr >> shift) <= ((addr + size - 1) >> shift) &&
+            ((entry.addr + entry.size - 1) >> shift) >= (addr >> shift))
+            found.push_back(idx);
+    }
+    return found;
+}
+
+int
+main()
+{
+    UnitTest::setCase("Basic");
+    {
+        LSQAddrIndex index;
+        index.init(8, 6);
+        index.insert(0, 0x1000, 8);
+        index.insert(1, 0x1008, 8);
+        index.insert(2, 0x2000, 4);
+
+        EXPECT_TRUE(overlaps(index, 0x1000, 4) == vector<int>({0, 1}));
+        EXPECT_TRUE(overlaps(index, 0x2020, 8) == vector<int>({2}));
+        EXPECT_TRUE(overlaps(index, 0x3000, 8).empty());
+
+        index.remove(0);
+        EXPECT_FALSE(index.contains(0));
+        EXPECT_TRUE(overlaps(index, 0x1000, 4) == vector<int>({1}));
+        index.remove(0);
+
+        // Moving an entry takes it out of its old bucket.
+        index.insert(1, 0x2000, 8);
+        EXPECT_TRUE(overlaps(index, 0x1000, 4).empty());
+        EXPECT_TRUE(overlaps(index, 0x2000, 4) == vector<int>({1, 2}));
+
+        index.clear();
+        EXPECT_TRUE(overlaps(index, 0x2000, 4).empty());
+    }
+
+    UnitTest::setCase("Spans");
+    {
+        LSQAddrIndex index;
+        index.init(8, 4);
+        // A split access and a cache block zeroing store.
+        index.insert(0, 0x103c, 8);
+        index.insert(1, 0x2000, 64);
+
+        EXPECT_TRUE(overlaps(index, 0x1040, 1) == vector<int>({0}));
+        EXPECT_TRUE(overlaps(index, 0x1038, 4) == vector<int>({0}));
+        EXPECT_TRUE(overlaps(index, 0x2038, 8) == vector<int>({1}));
+        EXPECT_TRUE(overlaps(index, 0x1ff8, 8).empty());
+        EXPECT_TRUE(overlaps(index, 0x2040, 8).empty());
+
+        // An access wider than there are buckets.
+        EXPECT_TRUE(overlaps(index, 0x1000, 0x1008) == vector<int>({0, 1}));
+    }
+
+    UnitTest::setCase("Random");
+    {
+        mt19937 rng(1);
+        const unsigned shift = 4;
+        unsigned num_entries = 33;
+        LSQAddrIndex index;
+        index.init(num_entries, shift);
+        vector<Access> queue(num_entries, Access{false, 0, 0});
+
+        bool matched = true;
+        for (int step = 0; step < 20000; ++step) {
+            if (step == 10000) {
+                num_entries = 65;
+                index.resize(num_entries);
+                queue.resize(num_entries, Access{false, 0, 0});
+            }
+
+            int idx = rng() % num_entries;
+            if (rng() % 3 == 0) {
+                index.remove(idx);
+                queue[idx].valid = false;
+            } else {
+                Addr addr = 0x10000 + rng() % 1024;
+                unsigned size = rng() % 8 == 0 ? 64 : 1 << (rng() % 4);
+                index.insert(idx, addr, size);
+                queue[idx] = Access{true, addr, size};
+            }
+
+            Addr addr = 0x10000 + rng() % 1024;
+            unsigned size = 1 << (rng() % 4);
+            if (overlaps(index, addr, size) !=
+                expected(queue, shift, addr, size))
+                matched = false;
+        }
+        EXPECT_TRUE(matched);
+    }
+
+    return UnitTest::printResults();
+}
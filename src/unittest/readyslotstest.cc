@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vector>
+
+#include "cpu/o3/ready_slots.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+/** Slots handed out by a select round until it runs dry. */
+static vector<int>
+selectAll(ReadySlots &slots)
+{
+    vector<int> selected;
+    int slot;
+    slots.startSelect();
+    while ((slot = slots.selectOldest()) >= 0)
+        selected.push_back(slot);
+    return selected;
+}
+
+int
+main()
+{
+    UnitTest::setCase("Allocation");
+    {
+        ReadySlots slots(130);
+        vector<int> taken;
+        for (int i = 0; i < 130; ++i)
+            taken.push_back(slots.allocate(i + 1, IntAluOp));
+        for (int i = 0; i < 130; ++i)
+            EXPECT_EQ(taken[i], i);
+        slots.release(70);
+        EXPECT_EQ(slots.allocate(500, IntAluOp), 70);
+        EXPECT_EQ(slots.seqNum(70), 500);
+        EXPECT_FALSE(slots.anyReady());
+    }
+
+    UnitTest::setCase("Oldest first");
+    {
+        ReadySlots slots(100);
+        // Younger instructions in lower slots, across words
+        int young = slots.allocate(30, IntAluOp);
+        for (int i = 0; i < 70; ++i)
+            slots.allocate(100 + i, IntAluOp);
+        int old = slots.allocate(10, MemReadOp);
+        int mid = slots.allocate(20, IntAluOp);
+        EXPECT_EQ(old, 71);
+        slots.setReady(young);
+        slots.setReady(old);
+        slots.setReady(mid);
+        EXPECT_EQ(slots.numReady(), 3);
+        EXPECT_EQ(selectAll(slots), vector<int>({old, mid, young}));
+        // Selecting doesn't issue
+        EXPECT_EQ(slots.numReady(), 3);
+    }
+
+    UnitTest::setCase("Issue and skip");
+    {
+        ReadySlots slots(64);
+        int alu0 = slots.allocate(1, IntAluOp);
+        int mem0 = slots.allocate(2, MemReadOp);
+        int alu1 = slots.allocate(3, IntAluOp);
+        int mem1 = slots.allocate(4, MemReadOp);
+        int mult = slots.allocate(5, IntMultOp);
+        for (int slot : {alu0, mem0, alu1, mem1, mult})
+            slots.setReady(slot);
+
+        slots.startSelect();
+        EXPECT_EQ(slots.selectOldest(), alu0);
+        slots.clearReady(alu0);
+        EXPECT_EQ(slots.selectOldest(), mem0);
+        // No FU for the loads this cycle
+        slots.skipOpClass(MemReadOp);
+        EXPECT_EQ(slots.selectOldest(), alu1);
+        slots.clearReady(alu1);
+        EXPECT_EQ(slots.selectOldest(), mult);
+        EXPECT_EQ(slots.selectOldest(), -1);
+
+        EXPECT_FALSE(slots.isReady(alu0));
+        EXPECT_TRUE(slots.isReady(mem0));
+        EXPECT_EQ(selectAll(slots), vector<int>({mem0, mem1, mult}));
+    }
+
+    UnitTest::setCase("Release and clear");
+    {
+        ReadySlots slots(8);
+        int a = slots.allocate(1, IntAluOp);
+        int b = slots.allocate(2, IntAluOp);
+        slots.setReady(a);
+        slots.setReady(b);
+        slots.startSelect();
+        slots.release(a);
+        EXPECT_EQ(slots.selectOldest(), b);
+        EXPECT_EQ(slots.numReady(), 1);
+
+        slots.clear();
+        EXPECT_FALSE(slots.anyReady());
+        for (int i = 0; i < 8; ++i)
+            EXPECT_EQ(slots.allocate(10 + i, IntAluOp), i);
+    }
+
+    return UnitTest::printResults();
+}
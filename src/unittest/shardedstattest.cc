@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+Stats::ShardedScalar scalar;
+Stats::ShardedVector vec;
+Stats::ShardedDistribution dist;
+Stats::ShardedVectorDistribution vdist;
+
+/** Update every stat from a number of threads at the same time. */
+void
+update(unsigned num_threads, unsigned iters)
+{
+    auto body = [iters](unsigned t) {
+        for (unsigned i = 0; i < iters; ++i) {
+            ++scalar;
+            vec[i % 2] += 2;
+            dist.sample(t * 10 + i % 10);
+            vdist[t % 2].sample(i % 10);
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned t = 1; t < num_threads; ++t)
+        threads.emplace_back(body, t);
+    body(0);
+    for (auto &t : threads)
+        t.join();
+}
+
+int
+main(int argc, char *argv[])
+{
+    const unsigned num_threads = 4;
+    const unsigned iters = 100000;
+    const Stats::Counter total = num_threads * iters;
+
+    scalar.name("scalar");
+    vec.init(2).name("vec");
+    dist.init(0, 99, 10).name("dist");
+    vdist.init(2, 0, 9, 1).name("vdist");
+
+    UnitTest::setCase("Concurrent updates are merged");
+    update(num_threads, iters);
+    EXPECT_EQ(scalar.value(), total);
+    EXPECT_EQ(vec.total(), 2 * total);
+    EXPECT_EQ(vec[1].value(), total);
+
+    Stats::DistInfo &dinfo =
+        *dynamic_cast<Stats::DistInfo *>(Stats::nameMap()["dist"]);
+    dist.prepare();
+    EXPECT_EQ(dinfo.data.samples, total);
+    EXPECT_EQ(dinfo.data.min_val, 0);
+    EXPECT_EQ(dinfo.data.max_val, (num_threads - 1) * 10 + 9);
+    for (unsigned t = 0; t < num_threads; ++t)
+        EXPECT_EQ(dinfo.data.cvec[t], iters);
+    EXPECT_EQ(dinfo.data.cvec[num_threads], 0);
+
+    Stats::VectorDistInfo &vinfo =
+        *dynamic_cast<Stats::VectorDistInfo *>(Stats::nameMap()["vdist"]);
+    vdist.prepare();
+    EXPECT_EQ(vinfo.data[0].samples, total / 2);
+    EXPECT_EQ(vinfo.data[1].cvec[9], total / 20);
+
+    UnitTest::setCase("Reset clears every thread");
+    scalar.reset();
+    vec.reset();
+    dist.reset();
+    EXPECT_TRUE(scalar.zero());
+    EXPECT_EQ(vec.total(), 0);
+    EXPECT_TRUE(dist.zero());
+
+    UnitTest::setCase("Set overrides every thread");
+    update(num_threads, 10);
+    scalar = 7;
+    EXPECT_EQ(scalar.value(), 7);
+
+    return UnitTest::printResults();
+}
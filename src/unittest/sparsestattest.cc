@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string>
+
+#include "base/statistics.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+Stats::Value simTicks;
+Stats::Value simFreq;
+Stats::Formula simSeconds;
+
+Stats::Scalar bytes;
+Stats::Vector masterBytes;
+Stats::Formula bw;
+Stats::Formula masterBw;
+Stats::Formula bitRate;
+Stats::Formula total;
+Stats::Formula constOnly;
+
+static bool
+untouched(const string &name)
+{
+    return Stats::nameMap()[name]->untouched();
+}
+
+int
+main()
+{
+    Tick ticks = 1000000;
+    Tick freq = 1000000000000;
+
+    // The same time stats as sim/stat_control.cc.
+    simTicks.scalar(ticks).name("sim_ticks");
+    simFreq.scalar(freq).name("sim_freq");
+    simSeconds.name("sim_seconds");
+    simSeconds = simTicks / simFreq;
+
+    bytes.name("bytes");
+    masterBytes.init(2).name("master_bytes");
+    bw.name("bw");
+    bw = bytes / simSeconds;
+    masterBw.name("master_bw");
+    masterBw = masterBytes / simSeconds;
+    bitRate.name("bit_rate");
+    bitRate = bytes * Stats::constant(8) / simSeconds;
+    total.name("total");
+    total = bytes + sum(masterBytes);
+    constOnly.name("const_only");
+    constOnly = Stats::constant(4) * 2;
+
+    UnitTest::setCase("Rates of untouched stats are untouched");
+    EXPECT_TRUE(untouched("bytes"));
+    EXPECT_TRUE(untouched("bw"));
+    EXPECT_TRUE(untouched("master_bw"));
+    EXPECT_TRUE(untouched("bit_rate"));
+    EXPECT_TRUE(untouched("total"));
+
+    UnitTest::setCase("Formulas without counting stats are touched");
+    EXPECT_FALSE(untouched("sim_seconds"));
+    EXPECT_FALSE(untouched("const_only"));
+
+    UnitTest::setCase("Touching a stat touches its formulas");
+    bytes += 64;
+    EXPECT_FALSE(untouched("bw"));
+    EXPECT_FALSE(untouched("bit_rate"));
+    EXPECT_FALSE(untouched("total"));
+    EXPECT_TRUE(untouched("master_bw"));
+
+    masterBytes[1] += 64;
+    EXPECT_FALSE(untouched("master_bw"));
+
+    bytes.reset();
+    masterBytes.reset();
+    EXPECT_TRUE(untouched("bw"));
+    EXPECT_TRUE(untouched("master_bw"));
+    EXPECT_TRUE(untouched("total"));
+    EXPECT_FALSE(untouched("const_only"));
+
+    return UnitTest::printResults();
+}
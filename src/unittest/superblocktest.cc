@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/isa_traits.hh"
+#include "cpu/simple/superblock_cache.hh"
+#include "cpu/static_inst.hh"
+#include "unittest/unittest.hh"
+
+/** Record a block of num_insts instructions starting at a PC. */
+static void
+recordBlock(SuperblockCache &cache, Addr paddr, Addr pc, unsigned num_insts,
+            uint64_t context = 0)
+{
+    const uint8_t code[4] = { 1, 2, 3, 4 };
+    cache.startBlock(paddr, context);
+    for (unsigned i = 0; i < num_insts && cache.recording(); ++i) {
+        TheISA::PCState fetch_pc(pc + 4 * i);
+        cache.recordCode(paddr + 4 * i, code, sizeof(code));
+        cache.record(fetch_pc, fetch_pc, StaticInstPtr());
+    }
+    cache.endBlock();
+}
+
+int
+main()
+{
+    const Addr page = TheISA::PageBytes;
+
+    UnitTest::setCase("Lookup");
+    {
+        SuperblockCache cache(8, 16);
+        recordBlock(cache, 2 * page + 0x40, 0x10040, 3, 5);
+        EXPECT_EQ(cache.size(), 1);
+        EXPECT_FALSE(cache.recording());
+
+        const SuperblockCache::Block *block =
+            cache.lookup(2 * page + 0x40, TheISA::PCState(0x10040), 5);
+        EXPECT_TRUE(block != nullptr);
+        if (block) {
+            EXPECT_EQ(block->insts.size(), 3);
+            EXPECT_EQ(block->insts[2].pc.instAddr(), 0x10048);
+        }
+
+        // Another virtual address, decoder context or physical address.
+        EXPECT_TRUE(!cache.lookup(2 * page + 0x40,
+                                  TheISA::PCState(0x20040), 5));
+        EXPECT_TRUE(!cache.lookup(2 * page + 0x40,
+                                  TheISA::PCState(0x10040), 6));
+        EXPECT_TRUE(!cache.lookup(3 * page + 0x40,
+                                  TheISA::PCState(0x10040), 5));
+
+        // Recording at the same address replaces the block.
+        recordBlock(cache, 2 * page + 0x40, 0x20040, 2, 5);
+        EXPECT_EQ(cache.size(), 1);
+        EXPECT_TRUE(!cache.lookup(2 * page + 0x40,
+                                  TheISA::PCState(0x10040), 5));
+        EXPECT_TRUE(cache.lookup(2 * page + 0x40,
+                                 TheISA::PCState(0x20040), 5) != nullptr);
+
+        // Empty blocks aren't kept.
+        cache.startBlock(4 * page, 0);
+        cache.endBlock();
+        EXPECT_EQ(cache.size(), 1);
+    }
+
+    UnitTest::setCase("Block size");
+    {
+        SuperblockCache cache(4, 16);
+        recordBlock(cache, page, 0x1000, 10);
+        const SuperblockCache::Block *block =
+            cache.lookup(page, TheISA::PCState(0x1000), 0);
+        EXPECT_TRUE(block != nullptr);
+        if (block)
+            EXPECT_EQ(block->insts.size(), 4);
+    }
+
+    UnitTest::setCase("Invalidation");
+    {
+        SuperblockCache cache(8, 16);
+        recordBlock(cache, page, 0x1000, 2);
+        recordBlock(cache, page + 0x100, 0x1100, 2);
+        recordBlock(cache, 2 * page, 0x2000, 2);
+        EXPECT_EQ(cache.size(), 3);
+
+        EXPECT_EQ(cache.invalidate(3 * page, 8), 0);
+        EXPECT_EQ(cache.invalidate(page + 0x800, 4), 2);
+        EXPECT_EQ(cache.size(), 1);
+        EXPECT_TRUE(!cache.lookup(page, TheISA::PCState(0x1000), 0));
+
+        // A write across a page boundary.
+        recordBlock(cache, page, 0x1000, 2);
+        EXPECT_EQ(cache.invalidate(2 * page - 4, 8), 2);
+        EXPECT_EQ(cache.size(), 0);
+
+        // Writing the page of the block being recorded abandons it.
+        cache.startBlock(page, 0);
+        cache.record(TheISA::PCState(0x1000), TheISA::PCState(0x1000),
+                     StaticInstPtr());
+        cache.invalidate(page + 0x10, 4);
+        EXPECT_FALSE(cache.recording());
+        cache.endBlock();
+        EXPECT_EQ(cache.size(), 0);
+    }
+
+    UnitTest::setCase("Code");
+    {
+        SuperblockCache cache(8, 16);
+        const uint8_t first[4] = { 1, 2, 3, 4 };
+        const uint8_t second[2] = { 5, 6 };
+        const uint8_t before[2] = { 7, 8 };
+
+        // Fetches with a gap, and one before the start of the block.
+        cache.startBlock(page + 0x10, 0);
+        cache.recordCode(page + 0x10, first, sizeof(first));
+        cache.record(TheISA::PCState(0x1010), TheISA::PCState(0x1010),
+                     StaticInstPtr());
+        cache.recordCode(page + 0x16, second, sizeof(second));
+        cache.recordCode(page + 0x0c, before, sizeof(before));
+        cache.endBlock();
+
+        const SuperblockCache::Block *block =
+            cache.lookup(page + 0x10, TheISA::PCState(0x1010), 0);
+        EXPECT_TRUE(block != nullptr);
+        if (block) {
+            EXPECT_EQ(block->codeAddr, page + 0x0c);
+            EXPECT_EQ(block->code.size(), 12);
+
+            uint8_t mem[12] = { 7, 8, 0, 0, 1, 2, 3, 4, 0, 0, 5, 6 };
+            EXPECT_TRUE(block->codeMatches(mem));
+
+            // Bytes that were never fetched don't matter.
+            mem[2] = 0x55;
+            mem[9] = 0xaa;
+            EXPECT_TRUE(block->codeMatches(mem));
+
+            mem[5] = 0;
+            EXPECT_FALSE(block->codeMatches(mem));
+        }
+
+        // Code from another page abandons the block.
+        cache.startBlock(2 * page - 8, 0);
+        cache.recordCode(2 * page - 8, first, sizeof(first));
+        cache.record(TheISA::PCState(0x1ff8), TheISA::PCState(0x1ff8),
+                     StaticInstPtr());
+        cache.recordCode(2 * page - 2, first, sizeof(first));
+        EXPECT_FALSE(cache.recording());
+        cache.endBlock();
+        EXPECT_TRUE(!cache.lookup(2 * page - 8, TheISA::PCState(0x1ff8), 0));
+    }
+
+    UnitTest::setCase("Capacity");
+    {
+        SuperblockCache cache(8, 4);
+        for (int i = 0; i < 4; ++i)
+            recordBlock(cache, i * page, i * page, 1);
+        EXPECT_EQ(cache.size(), 4);
+        recordBlock(cache, 4 * page, 4 * page, 1);
+        EXPECT_EQ(cache.size(), 1);
+        EXPECT_TRUE(cache.lookup(4 * page, TheISA::PCState(4 * page), 0) !=
+                    nullptr);
+    }
+
+    return UnitTest::printResults();
+}
@@ -0,0 +1,248 @@
+#!/usr/bin/env python2
+#
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import os
+import sys
+
+from testing.bench import *
+
+class ParagraphHelpFormatter(argparse.HelpFormatter):
+    def _fill_text(self, text, width, indent):
+        return "\n\n".join([
+            super(ParagraphHelpFormatter, self)._fill_text(p, width, indent) \
+            for p in text.split("\n\n") ])
+
+def _add_select_args(parser):
+    parser.add_argument("--isa", type=str, default="x86",
+                        help="Guest ISA of the benchmarks")
+
+    parser.add_argument("--ruby", action="store_true",
+                        help="Include the Ruby configurations")
+
+    parser.add_argument("--workload", type=str, action="append",
+                        help="Only run this workload (repeatable)")
+
+    parser.add_argument("--config", type=str, action="append",
+                        help="Only run this configuration (repeatable)")
+
+def _select(args, ruby):
+    return list(get_benchmarks(args.isa, ruby=ruby,
+                               workloads=args.workload,
+                               configs=args.config))
+
+def _print_result(res, status, change, breakdown=0):
+    if not res.ok():
+        print "%-50s %s" % (res.name, res.state)
+        return
+
+    line = "%-50s %9.2f s %9.1f KIPS  %-6s %s" % (
+        res.name, res.seconds(), res.kips(), status,
+        "%+.1f%%" % (100 * change) if change is not None else "")
+    print line.rstrip()
+
+    events = sorted(res.breakdown.items(), key=lambda e: -e[1])
+    total = sum(res.breakdown.values())
+    for event, secs in events[:breakdown]:
+        print "    %6.1f%%  %s" % (100 * secs / total, event)
+    for counter in ("ipc", "llcMPKI", "branchMPKI"):
+        if breakdown and counter in res.counters:
+            print "    %s: %.3f" % (counter, res.counters[counter])
+
+def _list_args(subparsers):
+    parser = subparsers.add_parser(
+        "list",
+        formatter_class=ParagraphHelpFormatter,
+        help="List available benchmarks")
+
+    _add_select_args(parser)
+
+def _list(args):
+    for bench in _select(args, args.ruby):
+        print bench_name(bench)
+
+def _run_args(subparsers):
+    parser = subparsers.add_parser(
+        "run",
+        formatter_class=ParagraphHelpFormatter,
+        help="Run benchmarks and record the results",
+        description="Run benchmarks and record the results.",
+        epilog="""
+        Every benchmark is run --repeat times and the fastest run is
+        recorded, followed by a profiled run that breaks down the host
+        time per event type (and reports the host's performance
+        counters if gem5 was built with the HostProfiler). Use a
+        gem5.fast binary for representative numbers.
+
+        The SE workloads are in tests/bench/se/. Except for hello,
+        their binaries are built with the Makefile in
+        tests/test-progs/bench/src/, workloads without a binary are
+        skipped.
+
+        Results are compared to the median of the previous runs on the
+        same host in the database. The exit code is 3 if any benchmark
+        is slower than the threshold, 2 if any failed to run.""")
+
+    parser.add_argument("gem5", type=str,
+                        help="gem5 binary")
+
+    parser.add_argument("--ruby-gem5", type=str, default=None,
+                        help="gem5 binary built with Ruby, enables the " \
+                        "Ruby configurations")
+
+    _add_select_args(parser)
+
+    parser.add_argument("--directory", "-d",
+                        type=str, default="m5bench",
+                        help="Benchmark work directory")
+
+    parser.add_argument("--database", type=str, default="bench.json",
+                        help="Results database, created if missing")
+
+    parser.add_argument("--label", type=str, default="",
+                        help="Label recorded with the results, e.g., " \
+                        "a revision")
+
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Timed runs per benchmark")
+
+    parser.add_argument("--no-profile", action="store_true",
+                        help="Skip the profiled runs")
+
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        metavar="PERCENT",
+                        help="Slowdown flagged as a regression")
+
+    parser.add_argument("--history", type=int, default=5,
+                        help="Previous runs the reference is based on")
+
+    parser.add_argument("--breakdown", type=int, default=5,
+                        metavar="N",
+                        help="Event types shown per benchmark")
+
+    parser.add_argument("--timeout", "-t",
+                        type=int, default="0", metavar="MINUTES",
+                        help="Timeout, 0 to disable")
+
+def _run(args):
+    for gem5 in (args.gem5, args.ruby_gem5):
+        if gem5 and not (os.path.isfile(gem5) and os.access(gem5, os.X_OK)):
+            print >> sys.stderr, \
+                "gem5 binary '%s' not an executable file" % gem5
+            sys.exit(1)
+
+    db = Database(args.database)
+    out_base = os.path.abspath(args.directory)
+
+    failed, slower = False, False
+    for bench in _select(args, args.ruby_gem5 is not None):
+        gem5 = args.ruby_gem5 if bench.config in ruby_configs else args.gem5
+        res = Benchmark(gem5, out_base, bench,
+                        repeat=args.repeat,
+                        profile=not args.no_profile,
+                        timeout=args.timeout * 60,
+                        label=args.label).run()
+
+        if res.state == "SKIPPED":
+            print "%-50s skipped" % res.name
+            continue
+
+        db.add(res)
+        status, change = compare(res, db.reference(res, args.history),
+                                 args.threshold / 100)
+        _print_result(res, status, change, args.breakdown)
+
+        if not res.ok():
+            failed = True
+            if args.verbose:
+                print res.message
+        slower = slower or status == "SLOWER"
+
+    sys.exit(2 if failed else (3 if slower else 0))
+
+def _show_args(subparsers):
+    parser = subparsers.add_parser(
+        "show",
+        formatter_class=ParagraphHelpFormatter,
+        help="Show the history of benchmarks in a database")
+
+    parser.add_argument("database", type=str,
+                        help="Results database")
+
+    parser.add_argument("--host", type=str, default=None,
+                        help="Only show results from this host")
+
+    parser.add_argument("benchmark", type=str, nargs="*",
+                        help="Benchmarks to show, all by default")
+
+def _show(args):
+    db = Database(args.database)
+    for res in db.results:
+        if args.benchmark and res.name not in args.benchmark:
+            continue
+        if args.host and res.host != args.host:
+            continue
+        if res.ok():
+            print "%s %-12s %-12s %-50s %9.2f s %9.1f KIPS" % (
+                res.date[:19], res.host, res.label, res.name,
+                res.seconds(), res.kips())
+        else:
+            print "%s %-12s %-12s %-50s %s" % (
+                res.date[:19], res.host, res.label, res.name, res.state)
+
+_commands = {
+    "list" : (_list, _list_args),
+    "run" : (_run, _run_args),
+    "show" : (_show, _show_args),
+}
+
+def main():
+    parser = argparse.ArgumentParser(
+        formatter_class=ParagraphHelpFormatter,
+        description="""gem5 host throughput benchmarks.""",
+        epilog="""
+        This tool measures how fast gem5 simulates a set of small SE
+        workloads with every CPU model and memory system, and tracks
+        the results over time to catch speed regressions (e.g.,
+        "bench.py run build/X86/gem5.fast --label $(git rev-parse
+        --short HEAD)").""")
+
+    parser.add_argument("--verbose", action="store_true",
+                        help="Produce more verbose output")
+
+    subparsers = parser.add_subparsers(dest="command")
+
+    for key, (impl, cmd_parser) in _commands.items():
+        cmd_parser(subparsers)
+
+    args = parser.parse_args()
+    impl, cmd_parser = _commands[args.command]
+    impl(args)
+
+if __name__ == "__main__":
+    main()
@@ -191,6 +191,14 @@ maxtick = m5.MaxTick
 sys.path.append(joinpath(tests_root, category, mode, name))
 execfile(joinpath(tests_root, category, mode, name, 'test.py'))
 
+# Benchmark runs may ask where the host time goes (see bench.py). This
+# slows down the simulation, so it's only done in separate runs.
+if category == 'bench' and os.environ.get('M5_BENCH_PROFILE'):
+    root.eventq_profile = True
+    root.eventq_profile_entries = 64
+    if has_sim_object('HostProfiler'):
+        root.host_profiler = m5.objects.HostProfiler()
+
 # Initialize all CPUs in a system
 def initCPUs(sys):
     def initCPU(cpu):
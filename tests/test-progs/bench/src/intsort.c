@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Host throughput benchmark: sort pseudo-random integers. Mostly
+ * integer ALU operations and hard to predict branches.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define N 32768
+
+static uint32_t data[N];
+
+static void
+sort(uint32_t *a, int n)
+{
+    while (n > 16) {
+        uint32_t pivot = a[n / 2];
+        int i = 0, j = n - 1;
+        while (i <= j) {
+            while (a[i] < pivot)
+                i++;
+            while (a[j] > pivot)
+                j--;
+            if (i <= j) {
+                uint32_t t = a[i];
+                a[i++] = a[j];
+                a[j--] = t;
+            }
+        }
+        // Recurse on the smaller half to bound the stack depth
+        if (j + 1 < n - i) {
+            sort(a, j + 1);
+            a += i;
+            n -= i;
+        } else {
+            sort(a + i, n - i);
+            n = j + 1;
+        }
+    }
+
+    for (int i = 1; i < n; i++) {
+        uint32_t v = a[i];
+        int j = i - 1;
+        while (j >= 0 && a[j] > v) {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = v;
+    }
+}
+
+int
+main()
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 8;
+    }
+
+    sort(data, N);
+
+    uint32_t sum = 0;
+    for (int i = 0; i < N; i++) {
+        if (i > 0 && data[i - 1] > data[i]) {
+            printf("intsort: not sorted at %d\n", i);
+            return 1;
+        }
+        sum = sum * 31 + data[i];
+    }
+
+    printf("intsort: %08x\n", sum);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Host throughput benchmark: chase pointers through a random cycle
+ * over a few MB. Mostly dependent loads that miss in the simulated
+ * caches.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define N (256 * 1024)
+#define STEPS (1024 * 1024)
+
+static uint32_t next[N];
+
+int
+main()
+{
+    // Sattolo's algorithm, which yields a single cycle through all
+    // the entries
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < N; i++)
+        next[i] = i;
+    for (uint32_t i = N - 1; i > 0; i--) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t j = (seed >> 8) % i;
+        uint32_t t = next[i];
+        next[i] = next[j];
+        next[j] = t;
+    }
+
+    uint32_t p = 0, sum = 0;
+    for (uint32_t i = 0; i < STEPS; i++) {
+        p = next[p];
+        sum = sum * 31 + p;
+    }
+
+    printf("pchase: %08x\n", sum);
+    return 0;
+}
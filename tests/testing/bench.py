@@ -0,0 +1,270 @@
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Host throughput benchmarks.
+
+The benchmarks measure how fast gem5 itself runs, i.e., the host
+seconds and simulated KIPS of small SE-mode workloads (tests/bench/se/)
+on every CPU model, with the classic memory system and with
+Ruby. Results are appended to a database to track the simulation
+speed over time and to flag runs that are slower than the previous
+ones.
+
+"""
+
+from collections import namedtuple
+from datetime import datetime
+import json
+import os
+import platform
+import re
+
+from units import RunGem5
+
+_test_base = os.path.join(os.path.dirname(__file__), "..")
+
+BenchConfig = namedtuple("BenchConfig", (
+    "workload",
+    "isa",
+    "os",
+    "config",
+))
+
+# Configurations from tests/configs/ that are benchmarked, one per CPU
+# model and memory system. The Ruby configurations need a gem5 binary
+# built with a Ruby protocol.
+classic_configs = (
+    'simple-atomic',
+    'simple-timing',
+    'minor-timing',
+    'o3-timing',
+)
+
+ruby_configs = (
+    'simple-timing-ruby',
+    'o3-timing-ruby',
+)
+
+def bench_name(bench):
+    return "/".join(bench)
+
+def get_benchmarks(isa, ruby=False, workloads=None, configs=None):
+    """List the benchmarks of an ISA, optionally restricted to a
+    subset of the workloads and configurations."""
+
+    all_configs = classic_configs + (ruby_configs if ruby else ())
+    bench_dir = os.path.join(_test_base, "bench", "se")
+    for workload in sorted(os.listdir(bench_dir)):
+        if workloads and workload not in workloads:
+            continue
+        for config in all_configs:
+            if configs and config not in configs:
+                continue
+            yield BenchConfig(workload, isa, "linux", config)
+
+def read_stats(fname):
+    """Read the numeric stats of a text stats file, the last dump
+    wins."""
+
+    stats = {}
+    with open(fname, "r") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 2:
+                continue
+            try:
+                stats[fields[0]] = float(fields[1])
+            except ValueError:
+                pass
+    return stats
+
+# Host time per event type, as reported by the event queue profilers
+_event_time_rex = re.compile(r"^root\.eventq\d+\.eventHostSeconds::(.+)$")
+
+def event_breakdown(stats):
+    """Host seconds per event type, summed over all event queues."""
+
+    breakdown = {}
+    for name, value in stats.items():
+        m = _event_time_rex.match(name)
+        if m and m.group(1) != "total" and value > 0:
+            breakdown[m.group(1)] = breakdown.get(m.group(1), 0.0) + value
+    return breakdown
+
+class BenchResult(object):
+    """Results of one benchmark, as stored in the database."""
+
+    def __init__(self, name, host="", label="", date="", host_seconds=[],
+                 sim_insts=0, breakdown={}, counters={},
+                 state="OK", message=""):
+        self.name = name
+        self.host = host
+        self.label = label
+        self.date = date
+        self.host_seconds = list(host_seconds)
+        self.sim_insts = sim_insts
+        self.breakdown = dict(breakdown)
+        self.counters = dict(counters)
+        self.state = state
+        self.message = message
+
+    def ok(self):
+        return self.state == "OK"
+
+    def seconds(self):
+        """Host seconds of the fastest run, the least noisy estimate"""
+        return min(self.host_seconds) if self.host_seconds else None
+
+    def kips(self):
+        secs = self.seconds()
+        return self.sim_insts / secs / 1000 if secs else None
+
+    def to_dict(self):
+        return dict(self.__dict__)
+
+    @staticmethod
+    def from_dict(d):
+        return BenchResult(**d)
+
+class Benchmark(object):
+    """A benchmark run, i.e., one or more timed gem5 runs and an
+    optional profiled run that breaks down where the host time goes.
+
+    The profiled run enables the event queue profiler and, if gem5 was
+    built with it, the HostProfiler. It's kept separate since
+    profiling slows down the simulation.
+
+    """
+
+    def __init__(self, gem5, output_dir, bench,
+                 repeat=3, profile=True, timeout=0, label=""):
+        self.gem5 = os.path.abspath(gem5)
+        self.script = os.path.join(_test_base, "run.py")
+        self.output_dir = output_dir
+        self.bench = bench
+        self.repeat = repeat
+        self.profile = profile
+        self.timeout = timeout
+        self.label = label
+
+    def _run_gem5(self, test_dir, profile=False):
+        env = dict(os.environ)
+        if profile:
+            env["M5_BENCH_PROFILE"] = "1"
+        else:
+            env.pop("M5_BENCH_PROFILE", None)
+
+        unit = RunGem5(self.gem5,
+                       [ self.script,
+                         "/".join(("bench", "se") + tuple(self.bench)) ],
+                       timeout=self.timeout, env=env,
+                       ref_dir="", test_dir=test_dir)
+        result = unit.run()
+        stats = {}
+        if result.success():
+            stats = read_stats(os.path.join(test_dir, "stats.txt"))
+        return result, stats
+
+    def run(self):
+        name = bench_name(self.bench)
+        res = BenchResult(name,
+                          host=platform.node(), label=self.label,
+                          date=datetime.utcnow().isoformat())
+
+        def failed(result):
+            res.state = result.state_name()
+            res.message = "%s\n%s" % (result.message, result.stderr)
+            return res
+
+        for i in range(self.repeat):
+            result, stats = self._run_gem5(
+                os.path.join(self.output_dir, name, "run%d" % i))
+            if not result.success():
+                return failed(result)
+            res.host_seconds.append(stats["host_seconds"])
+            res.sim_insts = stats["sim_insts"]
+
+        if self.profile:
+            result, stats = self._run_gem5(
+                os.path.join(self.output_dir, name, "profile"), profile=True)
+            if not result.success():
+                return failed(result)
+            res.breakdown = event_breakdown(stats)
+            res.counters = dict(
+                (k[len("host_profiler."):], v)
+                for k, v in stats.items() if k.startswith("host_profiler."))
+
+        return res
+
+class Database(object):
+    """Benchmark results, stored as one JSON object per line so that
+    runs can be appended."""
+
+    def __init__(self, fname):
+        self.fname = fname
+        self.results = []
+        if os.path.exists(fname):
+            with open(fname, "r") as f:
+                self.results = [ BenchResult.from_dict(json.loads(l))
+                                 for l in f if l.strip() ]
+
+    def add(self, result):
+        self.results.append(result)
+        with open(self.fname, "a") as f:
+            f.write(json.dumps(result.to_dict(), sort_keys=True) + "\n")
+
+    def reference(self, result, history=5):
+        """Reference host seconds of a benchmark, i.e., the median of
+        the previous successful runs on the same host, or None if there
+        are none."""
+
+        previous = [ r.seconds() for r in self.results
+                     if r is not result and r.ok() and
+                     r.name == result.name and r.host == result.host ]
+        previous = sorted(previous[-history:])
+        if not previous:
+            return None
+        return previous[len(previous) // 2]
+
+def compare(result, reference, threshold):
+    """Compare a result to its reference host seconds.
+
+    Returns a (status, change) tuple where change is the relative
+    change in host seconds and status is one of "NEW", "SLOWER",
+    "FASTER" or "OK".
+
+    """
+
+    if reference is None or not result.ok():
+        return "NEW", None
+
+    change = result.seconds() / reference - 1
+    if change > threshold:
+        return "SLOWER", change
+    elif change < -threshold:
+        return "FASTER", change
+    else:
+        return "OK", change
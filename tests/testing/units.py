@@ -136,11 +136,12 @@ class RunGem5(TestUnit):
        - exit code == 2 -> STATE_SKIPPED
     """
 
-    def __init__(self, gem5, gem5_args, timeout=0, **kwargs):
+    def __init__(self, gem5, gem5_args, timeout=0, env=None, **kwargs):
         super(RunGem5, self).__init__("gem5", **kwargs)
         self.gem5 = gem5
         self.args = gem5_args
         self.timeout = timeout
+        self.env = env
 
     def _run(self):
         gem5_cmd = [
@@ -152,7 +153,7 @@ class RunGem5(TestUnit):
 
         try:
             with ProcessHelper(gem5_cmd, stdout=subprocess.PIPE,
-                               stderr=subprocess.PIPE) as p:
+                               stderr=subprocess.PIPE, env=self.env) as p:
                 status, gem5_stdout, gem5_stderr = p.call(timeout=self.timeout)
         except CallTimeoutException as te:
             return self.error("Timeout", stdout=te.stdout, stderr=te.stderr)
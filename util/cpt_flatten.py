@@ -0,0 +1,146 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2017 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Flatten an incremental checkpoint into a self-contained one.
+#
+# An incremental checkpoint (System.incremental_checkpoint) only
+# stores the memory pages that changed since its parent checkpoint,
+# and restoring it requires the whole chain of parents. This script
+# rebuilds the full memory image of every incremental backing store
+# from the chain and writes a copy of the checkpoint that no longer
+# refers to any parent.
+#
+# Usage: cpt_flatten.py <checkpoint dir> <output dir>
+
+from ConfigParser import ConfigParser
+import gzip
+import os
+import shutil
+import struct
+import sys
+
+page_size = 4096
+
+class CptConfig(ConfigParser):
+    def optionxform(self, optionstr):
+        return optionstr
+
+def read_config(cpt_dir):
+    config = CptConfig()
+    path = os.path.join(cpt_dir, 'm5.cpt')
+    if not config.read(path):
+        raise IOError("Can't read checkpoint '%s'" % path)
+    return config
+
+def store_format(config, sec):
+    if config.has_option(sec, 'format'):
+        return config.get(sec, 'format')
+    return 'gzip'
+
+def restore_store(cpt_dir, sec, image):
+    """Restore the backing store in section sec of the checkpoint in
+    cpt_dir into image, parents first."""
+    config = read_config(cpt_dir)
+    if config.getint(sec, 'range_size') != len(image):
+        raise ValueError("Size of %s in '%s' does not match its child" %
+                         (sec, cpt_dir))
+
+    path = os.path.join(cpt_dir, config.get(sec, 'filename'))
+    fmt = store_format(config, sec)
+    if fmt == 'gzip':
+        f = gzip.open(path, 'rb')
+        image[:] = f.read()
+        f.close()
+    elif fmt == 'raw':
+        f = open(path, 'rb')
+        image[:] = f.read(len(image))
+        f.close()
+    elif fmt == 'delta':
+        parent = config.get(sec, 'parent')
+        restore_store(os.path.join(cpt_dir, parent), sec, image)
+
+        f = gzip.open(path, 'rb')
+        while True:
+            header = f.read(8)
+            if len(header) < 8:
+                break
+            page, = struct.unpack('=Q', header)
+            start = page * page_size
+            end = min(start + page_size, len(image))
+            image[start:end] = f.read(end - start)
+        f.close()
+    else:
+        raise ValueError("Unknown format '%s' of %s in '%s'" %
+                         (fmt, sec, cpt_dir))
+
+def flatten(cpt_dir, out_dir):
+    config = read_config(cpt_dir)
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+
+    stores = [ sec for sec in config.sections()
+               if store_format(config, sec) == 'delta' ]
+    store_files = [ config.get(sec, 'filename') for sec in stores ]
+
+    # copy everything but the incremental stores
+    for name in os.listdir(cpt_dir):
+        if name != 'm5.cpt' and name not in store_files:
+            src = os.path.join(cpt_dir, name)
+            if os.path.isfile(src):
+                shutil.copy2(src, out_dir)
+
+    for sec in stores:
+        print "Flattening %s" % sec
+        image = bytearray(config.getint(sec, 'range_size'))
+        restore_store(cpt_dir, sec, image)
+
+        f = gzip.open(os.path.join(out_dir, config.get(sec, 'filename')),
+                      'wb')
+        chunk = 1 << 24
+        for start in xrange(0, len(image), chunk):
+            f.write(str(image[start:start + chunk]))
+        f.close()
+
+        for option in 'format', 'parent', 'dirty_pages':
+            config.remove_option(sec, option)
+
+    f = open(os.path.join(out_dir, 'm5.cpt'), 'w')
+    config.write(f)
+    f.close()
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print >>sys.stderr, "Usage: %s <checkpoint dir> <output dir>" % \
+            sys.argv[0]
+        sys.exit(1)
+
+    if os.path.realpath(sys.argv[1]) == os.path.realpath(sys.argv[2]):
+        print >>sys.stderr, "The output must not be the input checkpoint"
+        sys.exit(1)
+
+    flatten(sys.argv[1], sys.argv[2])
@@ -212,6 +212,15 @@ do_dump_reset_stats(int argc, char *argv[])
     m5_dump_reset_stats(ints[0], ints[1]);
 }
 
+void
+do_dump_trace(int argc, char *argv[])
+{
+    if (argc > 0)
+        usage();
+
+    m5_dump_trace();
+}
+
 void
 do_read_file(int argc, char *argv[])
 {
@@ -343,6 +352,7 @@ struct MainFunc mainfuncs[] = {
     { "resetstats",     do_reset_stats,      "[delay [period]]" },
     { "dumpstats",      do_dump_stats,       "[delay [period]]" },
     { "dumpresetstats", do_dump_reset_stats, "[delay [period]]" },
+    { "dumptrace",      do_dump_trace,       "" },
     { "readfile",       do_read_file,        "" },
     { "writefile",      do_write_file,       "<filename>" },
     { "execfile",       do_exec_file,        "" },
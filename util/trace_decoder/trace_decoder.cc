@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2017 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Render a binary debug trace, written with --debug-format=binary, as
+ * the text the simulator would have printed.
+ *
+ * Usage: trace_decoder <trace file> [output file]
+ */
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+
+using namespace std;
+
+// These match Trace::BinaryLogger in src/base/trace.hh
+enum RecordType : uint8_t {
+    FormatDef = 1,
+    NameDef,
+    Message,
+    Text,
+    Dump,
+};
+
+const uint32_t version = 1;
+const uint64_t MaxTick = (uint64_t)-1;
+
+class Reader
+{
+  protected:
+    istream &in;
+    const string &filename;
+
+  public:
+    Reader(istream &_in, const string &_filename)
+        : in(_in), filename(_filename)
+    {}
+
+    [[noreturn]] void
+    truncated()
+    {
+        cerr << filename << ": truncated record" << endl;
+        exit(1);
+    }
+
+    template <typename T>
+    T
+    get()
+    {
+        T value;
+        if (!in.read(reinterpret_cast<char *>(&value), sizeof(value)))
+            truncated();
+        return value;
+    }
+
+    string
+    getString()
+    {
+        const uint32_t length = get<uint32_t>();
+        string str(length, '\0');
+        if (length && !in.read(&str[0], length))
+            truncated();
+        return str;
+    }
+};
+
+/** Set an id of a table of definitions */
+void
+define(vector<string> &table, uint32_t id, string str)
+{
+    if (id >= table.size())
+        table.resize(id + 1);
+    table[id] = std::move(str);
+}
+
+const string &
+lookup(const vector<string> &table, uint32_t id, const string &filename)
+{
+    if (id >= table.size()) {
+        cerr << filename << ": undefined id " << id << endl;
+        exit(1);
+    }
+    return table[id];
+}
+
+/** Print a message like Trace::OstreamLogger::logMessage() */
+void
+print(ostream &out, uint64_t when, const string &name, const string &message)
+{
+    if (when != MaxTick)
+        ccprintf(out, "%7d: ", when);
+
+    if (!name.empty())
+        out << name << ": ";
+
+    out << message;
+}
+
+/** Format the arguments of a message like ccprintf() */
+string
+format(Reader &reader, const string &fmt, unsigned args)
+{
+    ostringstream message;
+    cp::Print printer(message, fmt);
+
+    for (unsigned i = 0; i < args; ++i) {
+        const char type = reader.get<char>();
+        switch (type) {
+          case 'c': printer.add_arg(reader.get<char>()); break;
+          case 'b': printer.add_arg(reader.get<signed char>()); break;
+          case 'B': printer.add_arg(reader.get<unsigned char>()); break;
+          case 'h': printer.add_arg(reader.get<int16_t>()); break;
+          case 'H': printer.add_arg(reader.get<uint16_t>()); break;
+          case 'i': printer.add_arg(reader.get<int32_t>()); break;
+          case 'I': printer.add_arg(reader.get<uint32_t>()); break;
+          case 'q': printer.add_arg(reader.get<int64_t>()); break;
+          case 'Q': printer.add_arg(reader.get<uint64_t>()); break;
+          case '?': printer.add_arg(reader.get<bool>()); break;
+          case 'd': printer.add_arg(reader.get<double>()); break;
+          case 'P':
+            printer.add_arg((const void *)reader.get<uint64_t>());
+            break;
+          case 's': printer.add_arg(reader.getString()); break;
+          default:
+            reader.truncated();
+        }
+    }
+
+    printer.end_args();
+    return message.str();
+}
+
+/** Print a block of data like Trace::Logger::dump() */
+void
+dump(ostream &out, uint64_t when, const string &name, const string &data)
+{
+    const int len = data.size();
+    int c, i, j;
+
+    for (i = 0; i < len; i += 16) {
+        ostringstream line;
+
+        ccprintf(line, "%08x  ", i);
+        c = len - i;
+        if (c > 16) c = 16;
+
+        for (j = 0; j < c; j++) {
+            ccprintf(line, "%02x ", data[i + j] & 0xff);
+            if ((j & 0xf) == 7 && j > 0)
+                ccprintf(line, " ");
+        }
+
+        for (; j < 16; j++)
+            ccprintf(line, "   ");
+        ccprintf(line, "  ");
+
+        for (j = 0; j < c; j++) {
+            int ch = data[i + j] & 0x7f;
+            ccprintf(line, "%c", (char)(isprint(ch) ? ch : ' '));
+        }
+
+        ccprintf(line, "\n");
+        print(out, when, name, line.str());
+
+        if (c < 16)
+            break;
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    if (argc != 2 && argc != 3) {
+        cerr << "Usage: " << argv[0] << " <trace file> [output file]"
+             << endl;
+        return 1;
+    }
+
+    const string filename(argv[1]);
+    ifstream in(filename, ios::binary);
+    if (!in) {
+        cerr << "Cannot open " << filename << endl;
+        return 1;
+    }
+
+    ofstream out_file;
+    if (argc == 3) {
+        out_file.open(argv[2]);
+        if (!out_file) {
+            cerr << "Cannot open " << argv[2] << endl;
+            return 1;
+        }
+    }
+    ostream &out = argc == 3 ? out_file : cout;
+
+    char magic[8];
+    Reader reader(in, filename);
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, "gem5trc", 8)) {
+        cerr << filename << " is not a binary debug trace" << endl;
+        return 1;
+    }
+    const uint32_t file_version = reader.get<uint32_t>();
+    if (file_version != version) {
+        cerr << filename << " has unsupported version " << file_version
+             << endl;
+        return 1;
+    }
+
+    vector<string> formats;
+    vector<string> names(1);
+
+    uint8_t type;
+    while (in.read(reinterpret_cast<char *>(&type), sizeof(type))) {
+        if (type == FormatDef || type == NameDef) {
+            const uint32_t id = reader.get<uint32_t>();
+            define(type == FormatDef ? formats : names, id,
+                   reader.getString());
+            continue;
+        }
+
+        const uint64_t when = reader.get<uint64_t>();
+        const string &name =
+            lookup(names, reader.get<uint32_t>(), filename);
+
+        switch (type) {
+          case Message: {
+            const string &fmt =
+                lookup(formats, reader.get<uint32_t>(), filename);
+            const unsigned args = reader.get<uint8_t>();
+            print(out, when, name, format(reader, fmt, args));
+            break;
+          }
+
+          case Text:
+            print(out, when, name, reader.getString());
+            break;
+
+          case Dump:
+            dump(out, when, name, reader.getString());
+            break;
+
+          default:
+            cerr << filename << ": unknown record type " << (int)type
+                 << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}